@@ -0,0 +1,374 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+/**
+ * Benchmark:     braid-advisor.c
+ *
+ * Interface:     C
+ *
+ * Requires:      only C-language support
+ *
+ * Compile with:  make braid-advisor   (or make sequential=yes braid-advisor)
+ *
+ * Help with:     braid-advisor -help
+ *
+ * Sample run:    braid-advisor -nt 100000 -cf 4 -costs 1e-3,2e-3 -lat 2e-6 -bw 1e10 -bytes 80000 -rho 0.1 -np 4096
+ *
+ * Description:   predicts the time to solution of an XBraid run from measured
+ *                costs, without running it.  The step cost on each level (e.g.,
+ *                from braid_TestPerformance), the message latency and
+ *                bandwidth, the message size and the convergence factor (e.g.,
+ *                from a small run) are given on the command line, together
+ *                with the solver settings.  The configurations up to the given
+ *                number of processors are ranked by braid_AdviseConfig(), and
+ *                the predicted speedup for the given settings is printed with
+ *                braid_PredictTime().  Runs on one processor.
+ **/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "braid.h"
+
+/*--------------------------------------------------------------------------
+ * User-defined routines and structures.  Nothing is solved, only BufSize is
+ * used, for the message size.
+ *--------------------------------------------------------------------------*/
+
+typedef struct _braid_App_struct
+{
+   int       bytes;       /* message size */
+} my_App;
+
+typedef struct _braid_Vector_struct
+{
+   double value;
+} my_Vector;
+
+int
+my_Step(braid_App        app,
+        braid_Vector     ustop,
+        braid_Vector     fstop,
+        braid_Vector     u,
+        braid_StepStatus status)
+{
+   return 0;
+}
+
+int
+my_Init(braid_App     app,
+        double        t,
+        braid_Vector *u_ptr)
+{
+   my_Vector *u;
+
+   u = (my_Vector *) malloc(sizeof(my_Vector));
+   (u->value) = 0.0;
+   *u_ptr = u;
+
+   return 0;
+}
+
+int
+my_Clone(braid_App     app,
+         braid_Vector  u,
+         braid_Vector *v_ptr)
+{
+   my_Vector *v;
+
+   v = (my_Vector *) malloc(sizeof(my_Vector));
+   (v->value) = (u->value);
+   *v_ptr = v;
+
+   return 0;
+}
+
+int
+my_Free(braid_App    app,
+        braid_Vector u)
+{
+   free(u);
+
+   return 0;
+}
+
+int
+my_Sum(braid_App    app,
+       double       alpha,
+       braid_Vector x,
+       double       beta,
+       braid_Vector y)
+{
+   (y->value) = alpha*(x->value) + beta*(y->value);
+
+   return 0;
+}
+
+int
+my_SpatialNorm(braid_App     app,
+               braid_Vector  u,
+               double       *norm_ptr)
+{
+   *norm_ptr = (u->value < 0.0) ? -(u->value) : (u->value);
+
+   return 0;
+}
+
+int
+my_Access(braid_App          app,
+          braid_Vector       u,
+          braid_AccessStatus astatus)
+{
+   return 0;
+}
+
+int
+my_BufSize(braid_App          app,
+           int                *size_ptr,
+           braid_BufferStatus bstatus)
+{
+   *size_ptr = (app->bytes);
+
+   return 0;
+}
+
+int
+my_BufPack(braid_App          app,
+           braid_Vector       u,
+           void               *buffer,
+           braid_BufferStatus bstatus)
+{
+   return 0;
+}
+
+int
+my_BufUnpack(braid_App          app,
+             void               *buffer,
+             braid_Vector       *u_ptr,
+             braid_BufferStatus bstatus)
+{
+   return my_Init(app, 0.0, u_ptr);
+}
+
+/*--------------------------------------------------------------------------
+ * Main driver
+ *--------------------------------------------------------------------------*/
+
+#define MAX_COSTS 30
+
+int main (int argc, char *argv[])
+{
+   braid_Core  core;
+   my_App     *app;
+   double      costs[MAX_COSTS], time, speedup;
+   char       *token;
+   int         rank, arg_index, niter;
+   int         ncosts = 0;
+
+   /* Advisor parameters */
+   int         ntime       = 65536;
+   int         max_levels  = 30;
+   int         min_coarse  = 2;
+   int         cfactor     = 2;
+   int         nrelax      = 1;
+   int         max_iter    = 100;
+   double      tol         = 1.0e-09;
+   int         periodic    = 0;
+   int         relax_cg    = 0;
+   double      latency     = 1.0e-06;
+   double      bandwidth   = 1.0e+10;
+   int         bytes       = 8;
+   double      rho         = 0.1;
+   int         max_nprocs  = 1024;
+   int         nbest       = 10;
+
+   /* Initialize MPI */
+   MPI_Init(&argc, &argv);
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   /* Parse command line */
+   arg_index = 1;
+   while (arg_index < argc)
+   {
+      if ( strcmp(argv[arg_index], "-help") == 0 )
+      {
+         if ( rank == 0 )
+         {
+            printf("\n");
+            printf(" XBraid configuration advisor, see the top of braid-advisor.c\n\n");
+            printf("   -nt   <ntime>        : set num points in time (default: 65536)\n");
+            printf("   -ml   <max_levels>   : set max levels (default: 30)\n");
+            printf("   -mc   <min_coarse>   : set min possible coarse level size (default: 2)\n");
+            printf("   -cf   <cfactor>      : set coarsening factor on all levels (default: 2)\n");
+            printf("   -nu   <nrelax>       : set num F-C relaxations (default: 1)\n");
+            printf("   -mi   <max_iter>     : set max iterations (default: 100)\n");
+            printf("   -tol  <tol>          : set the relative stopping tolerance (default: 1e-09)\n");
+            printf("   -periodic            : periodic problem\n");
+            printf("   -relaxcg             : relax on the coarsest grid\n\n");
+            printf("   -costs <c0,c1,...>   : seconds per step on each level, the last\n");
+            printf("                          one is used on coarser levels (default: 1e-03)\n");
+            printf("   -lat  <latency>      : seconds per message (default: 1e-06)\n");
+            printf("   -bw   <bandwidth>    : bytes per second (default: 1e+10)\n");
+            printf("   -bytes <size>        : bytes per message (default: 8)\n");
+            printf("   -rho  <rho>          : convergence factor (default: 0.1)\n");
+            printf("   -np   <max_nprocs>   : max processors in time (default: 1024)\n");
+            printf("   -nbest <n>           : print the n best configurations (default: 10)\n\n");
+         }
+         MPI_Finalize();
+         return (0);
+      }
+      else if ( strcmp(argv[arg_index], "-nt") == 0 )
+      {
+         arg_index++;
+         ntime = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-ml") == 0 )
+      {
+         arg_index++;
+         max_levels = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mc") == 0 )
+      {
+         arg_index++;
+         min_coarse = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-cf") == 0 )
+      {
+         arg_index++;
+         cfactor = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-nu") == 0 )
+      {
+         arg_index++;
+         nrelax = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mi") == 0 )
+      {
+         arg_index++;
+         max_iter = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-tol") == 0 )
+      {
+         arg_index++;
+         tol = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-periodic") == 0 )
+      {
+         arg_index++;
+         periodic = 1;
+      }
+      else if ( strcmp(argv[arg_index], "-relaxcg") == 0 )
+      {
+         arg_index++;
+         relax_cg = 1;
+      }
+      else if ( strcmp(argv[arg_index], "-costs") == 0 )
+      {
+         arg_index++;
+         token = strtok(argv[arg_index++], ",");
+         for (ncosts = 0; (token != NULL) && (ncosts < MAX_COSTS); ncosts++)
+         {
+            costs[ncosts] = atof(token);
+            token = strtok(NULL, ",");
+         }
+      }
+      else if ( strcmp(argv[arg_index], "-lat") == 0 )
+      {
+         arg_index++;
+         latency = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-bw") == 0 )
+      {
+         arg_index++;
+         bandwidth = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-bytes") == 0 )
+      {
+         arg_index++;
+         bytes = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-rho") == 0 )
+      {
+         arg_index++;
+         rho = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-np") == 0 )
+      {
+         arg_index++;
+         max_nprocs = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-nbest") == 0 )
+      {
+         arg_index++;
+         nbest = atoi(argv[arg_index++]);
+      }
+      else
+      {
+         if (rank == 0)
+         {
+            printf("ABORTING: incorrect command line parameter %s\n", argv[arg_index]);
+         }
+         MPI_Finalize();
+         return (1);
+      }
+   }
+
+   if (ncosts == 0)
+   {
+      costs[0] = 1.0e-03;
+      ncosts   = 1;
+   }
+
+   /* Set up a core with the settings to model, on this processor only */
+   app = (my_App *) malloc(sizeof(my_App));
+   (app->bytes) = bytes;
+
+   braid_Init(MPI_COMM_WORLD, MPI_COMM_SELF, 0.0, 1.0, ntime, app,
+              my_Step, my_Init, my_Clone, my_Free, my_Sum, my_SpatialNorm,
+              my_Access, my_BufSize, my_BufPack, my_BufUnpack, &core);
+
+   braid_SetMaxLevels(core, max_levels);
+   braid_SetMinCoarse(core, min_coarse);
+   braid_SetCFactor(core, -1, cfactor);
+   braid_SetNRelax(core, -1, nrelax);
+   braid_SetMaxIter(core, max_iter);
+   braid_SetRelTol(core, tol);
+   braid_SetPeriodic(core, periodic);
+   braid_SetRelaxOnlyCG(core, relax_cg);
+
+   braid_AdviseConfig(core, max_nprocs, ncosts, costs, latency, bandwidth, rho, nbest);
+
+   braid_PredictTime(core, max_nprocs, ncosts, costs, latency, bandwidth, rho,
+                     &time, &speedup, &niter);
+   if (rank == 0)
+   {
+      printf("  With max_levels = %d on %d processors: %d iterations, %1.3e s, speedup %1.2f\n\n",
+             max_levels, max_nprocs, niter, time, speedup);
+   }
+
+   braid_Destroy(core);
+   free(app);
+
+   MPI_Finalize();
+
+   return (0);
+}
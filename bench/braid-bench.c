@@ -0,0 +1,635 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory. Written by
+ * Jacob Schroder, Rob Falgout, Tzanio Kolev, Ulrike Yang, Veselin
+ * Dobrev, et al. LLNL-CODE-660355. All rights reserved.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+/**
+ * Benchmark:     braid-bench.c
+ *
+ * Interface:     C
+ *
+ * Requires:      only C-language support
+ *
+ * Compile with:  make braid-bench   (or make sequential=yes braid-bench)
+ *
+ * Help with:     braid-bench -help
+ *
+ * Sample run:    mpirun -np 4 braid-bench -nt 4096 -busy 100 -format json
+ *
+ * Description:   synthetic MGRIT workload for performance measurements.  Each
+ *                time step applies backward Euler to the system of decoupled
+ *                ODEs
+ *                   u_i' = -lambda u_i - alpha u_i^3,  i = 1, ..., vsize
+ *                (Newton's method per component when alpha > 0), and then
+ *                spends a configurable amount of extra time, either
+ *                busy-waiting or streaming through a work array.  Vector size,
+ *                message size and the cost of a step are set independently, so
+ *                compute and communication bound regimes can be studied
+ *                without a real application.
+ *
+ *                Each run prints one line of results (CSV or JSON) on
+ *                processor 0.  See sweep.sh for strong and weak scaling
+ *                studies over processors, levels, coarsening factors and
+ *                storage modes.
+ **/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "braid.h"
+
+/*--------------------------------------------------------------------------
+ * User-defined routines and structures
+ *--------------------------------------------------------------------------*/
+
+typedef struct _braid_App_struct
+{
+   int       rank;
+   int       vsize;       /* number of doubles in a vector */
+   int       msize;       /* number of doubles in a message */
+   double    lambda;      /* linear decay rate */
+   double    alpha;       /* strength of the cubic nonlinearity */
+   double    busy;        /* busy-wait seconds per step on the fine grid */
+   double    cscale;      /* busy-wait scaling on coarse levels */
+   int       stream;      /* streaming passes over the work array per step */
+   int       wsize;       /* size of each work array */
+   double   *work[3];     /* work arrays for the streaming kernel */
+   double    sink;        /* keeps the streaming kernel from being removed */
+
+   /* Counters, reset for each run */
+   double    nsteps;      /* time steps taken */
+   double    nsolves;     /* Newton iterations */
+   double    nbytes;      /* bytes packed into messages */
+   double    nmsgs;       /* messages packed */
+} my_App;
+
+typedef struct _braid_Vector_struct
+{
+   double   *values;
+} my_Vector;
+
+int
+my_Step(braid_App        app,
+        braid_Vector     ustop,
+        braid_Vector     fstop,
+        braid_Vector     u,
+        braid_StepStatus status)
+{
+   double   *uval = (u->values);
+   double   *sval = (ustop->values);
+   double    lambda = (app->lambda);
+   double    alpha  = (app->alpha);
+   double    tstart, tstop, dt, v, r, start, busy;
+   double   *a, *b, *c;
+   int       i, j, it, level, iters = 0;
+
+   braid_StepStatusGetTstartTstop(status, &tstart, &tstop);
+   braid_StepStatusGetLevel(status, &level);
+   dt = tstop - tstart;
+
+   if (alpha == 0.0)
+   {
+      for (i = 0; i < (app->vsize); i++)
+      {
+         uval[i] = uval[i] / (1.0 + lambda*dt);
+      }
+   }
+   else
+   {
+      /* Solve v + dt*(lambda v + alpha v^3) = u with Newton, starting at ustop */
+      for (i = 0; i < (app->vsize); i++)
+      {
+         v = sval[i];
+         for (it = 0; it < 20; it++)
+         {
+            r = v + dt*(lambda*v + alpha*v*v*v) - uval[i];
+            if (fabs(r) < 1.0e-12)
+            {
+               break;
+            }
+            v -= r / (1.0 + dt*(lambda + 3.0*alpha*v*v));
+         }
+         uval[i] = v;
+         iters = (it > iters) ? it : iters;
+      }
+      braid_StepStatusSetSolverIters(status, iters);
+      (app->nsolves) += iters;
+   }
+
+   /* Synthetic cost */
+   busy = (app->busy);
+   if (level > 0)
+   {
+      busy *= (app->cscale);
+   }
+   if (busy > 0.0)
+   {
+      start = MPI_Wtime();
+      while ((MPI_Wtime() - start) < busy)
+      {
+      }
+   }
+   a = (app->work[0]);
+   b = (app->work[1]);
+   c = (app->work[2]);
+   for (j = 0; j < (app->stream); j++)
+   {
+      for (i = 0; i < (app->wsize); i++)
+      {
+         a[i] = b[i] + 0.5*c[i];
+      }
+      (app->sink) += a[j % (app->wsize)];
+   }
+
+   (app->nsteps) += 1.0;
+
+   return 0;
+}
+
+int
+my_Init(braid_App     app,
+        double        t,
+        braid_Vector *u_ptr)
+{
+   my_Vector *u;
+   int        i;
+
+   u = (my_Vector *) malloc(sizeof(my_Vector));
+   (u->values) = (double *) malloc((app->vsize)*sizeof(double));
+   for (i = 0; i < (app->vsize); i++)
+   {
+      if (t == 0.0) /* Initial condition */
+      {
+         (u->values)[i] = 1.0;
+      }
+      else /* All other time points set to arbitrary values */
+      {
+         (u->values)[i] = 0.456 + 0.001*(i % 100);
+      }
+   }
+   *u_ptr = u;
+
+   return 0;
+}
+
+int
+my_Clone(braid_App     app,
+         braid_Vector  u,
+         braid_Vector *v_ptr)
+{
+   my_Vector *v;
+
+   v = (my_Vector *) malloc(sizeof(my_Vector));
+   (v->values) = (double *) malloc((app->vsize)*sizeof(double));
+   memcpy((v->values), (u->values), (app->vsize)*sizeof(double));
+   *v_ptr = v;
+
+   return 0;
+}
+
+int
+my_Free(braid_App    app,
+        braid_Vector u)
+{
+   free(u->values);
+   free(u);
+
+   return 0;
+}
+
+int
+my_Sum(braid_App     app,
+       double        alpha,
+       braid_Vector  x,
+       double        beta,
+       braid_Vector  y)
+{
+   int  i;
+
+   for (i = 0; i < (app->vsize); i++)
+   {
+      (y->values)[i] = alpha*(x->values)[i] + beta*(y->values)[i];
+   }
+
+   return 0;
+}
+
+int
+my_SpatialNorm(braid_App     app,
+               braid_Vector  u,
+               double       *norm_ptr)
+{
+   double  dot = 0.0;
+   int     i;
+
+   for (i = 0; i < (app->vsize); i++)
+   {
+      dot += (u->values)[i]*(u->values)[i];
+   }
+   *norm_ptr = sqrt(dot / (app->vsize));
+
+   return 0;
+}
+
+int
+my_Access(braid_App          app,
+          braid_Vector       u,
+          braid_AccessStatus astatus)
+{
+   return 0;
+}
+
+int
+my_BufSize(braid_App          app,
+           int                *size_ptr,
+           braid_BufferStatus bstatus)
+{
+   *size_ptr = (app->msize)*sizeof(double);
+   return 0;
+}
+
+int
+my_BufPack(braid_App          app,
+           braid_Vector       u,
+           void               *buffer,
+           braid_BufferStatus bstatus)
+{
+   double *dbuffer = buffer;
+   int     i;
+
+   memcpy(dbuffer, (u->values), (app->vsize)*sizeof(double));
+   /* Pad the message up to msize */
+   for (i = (app->vsize); i < (app->msize); i++)
+   {
+      dbuffer[i] = 0.0;
+   }
+   braid_BufferStatusSetSize( bstatus, (app->msize)*sizeof(double) );
+   (app->nbytes) += (app->msize)*sizeof(double);
+   (app->nmsgs)  += 1.0;
+
+   return 0;
+}
+
+int
+my_BufUnpack(braid_App          app,
+             void               *buffer,
+             braid_Vector       *u_ptr,
+             braid_BufferStatus bstatus)
+{
+   my_Vector *u;
+
+   u = (my_Vector *) malloc(sizeof(my_Vector));
+   (u->values) = (double *) malloc((app->vsize)*sizeof(double));
+   memcpy((u->values), buffer, (app->vsize)*sizeof(double));
+   *u_ptr = u;
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------
+ * Main driver
+ *--------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+   braid_Core  core;
+   my_App     *app;
+   MPI_Comm    comm;
+   double      tstart, tstop, time, tmin, tsum, rnorm, counts[5], gcounts[5];
+   double      bytes = 0.0, msgs = 0.0, steps = 0.0, solves = 0.0;
+   int         rank, nprocs, ntime, arg_index, i, rep;
+   int         nlevels = 0, niter = 0;
+
+   /* Benchmark parameters */
+   int         nt          = 1024;
+   int         ntpr        = 0;
+   int         max_levels  = 30;
+   int         min_coarse  = 2;
+   int         cfactor     = 2;
+   int         nrelax      = 1;
+   int         max_iter    = 100;
+   int         storage     = -1;
+   int         fmg         = 0;
+   int         reps        = 1;
+   int         vsize       = 1;
+   int         msize       = 0;
+   int         stream      = 0;
+   int         wsize       = 1<<20;
+   int         json        = 0;
+   int         header      = 0;
+   double      tol         = 1.0e-6;
+   double      busy        = 0.0;
+   double      cscale      = 1.0;
+   double      lambda      = 1.0;
+   double      alpha       = 0.0;
+
+   /* Initialize MPI */
+   MPI_Init(&argc, &argv);
+   comm   = MPI_COMM_WORLD;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &nprocs);
+
+   /* Parse command line */
+   arg_index = 1;
+   while (arg_index < argc)
+   {
+      if ( strcmp(argv[arg_index], "-help") == 0 )
+      {
+         if ( rank == 0 )
+         {
+            printf("\n");
+            printf(" Synthetic MGRIT benchmark, see the top of braid-bench.c\n\n");
+            printf("   -nt   <ntime>        : set num points in time (strong scaling, default: 1024)\n");
+            printf("   -ntpr <ntime>        : set num points in time per processor (weak scaling)\n");
+            printf("   -ml   <max_levels>   : set max levels (default: 30)\n");
+            printf("   -mc   <min_coarse>   : set min possible coarse level size (default: 2)\n");
+            printf("   -cf   <cfactor>      : set coarsening factor on all levels (default: 2)\n");
+            printf("   -nu   <nrelax>       : set num F-C relaxations (default: 1)\n");
+            printf("   -mi   <max_iter>     : set max iterations (default: 100)\n");
+            printf("   -tol  <tol>          : set absolute stopping tolerance (default: 1e-6)\n");
+            printf("   -storage <level>     : set full storage levels (default: -1)\n");
+            printf("   -fmg                 : use FMG cycling\n\n");
+            printf("   -vsize <n>           : set num doubles per vector (default: 1)\n");
+            printf("   -msize <n>           : set num doubles per message, at least vsize (default: vsize)\n");
+            printf("   -lambda <lambda>     : set the linear decay rate (default: 1)\n");
+            printf("   -nonlin <alpha>      : set the cubic nonlinearity, solved with Newton (default: 0)\n");
+            printf("   -busy <usec>         : busy-wait usec microseconds per step (default: 0)\n");
+            printf("   -cscale <s>          : scale the busy-wait by s on coarse levels (default: 1)\n");
+            printf("   -stream <npasses>    : stream npasses times through the work arrays per step (default: 0)\n");
+            printf("   -wsize <n>           : set num doubles per work array (default: 1048576)\n\n");
+            printf("   -reps <r>            : repeat the solve r times, report the fastest (default: 1)\n");
+            printf("   -format <csv|json>   : set the output format (default: csv)\n");
+            printf("   -header              : print the CSV header line first\n\n");
+         }
+         MPI_Finalize();
+         return (0);
+      }
+      else if ( strcmp(argv[arg_index], "-nt") == 0 )
+      {
+         arg_index++;
+         nt = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-ntpr") == 0 )
+      {
+         arg_index++;
+         ntpr = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-ml") == 0 )
+      {
+         arg_index++;
+         max_levels = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mc") == 0 )
+      {
+         arg_index++;
+         min_coarse = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-cf") == 0 )
+      {
+         arg_index++;
+         cfactor = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-nu") == 0 )
+      {
+         arg_index++;
+         nrelax = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mi") == 0 )
+      {
+         arg_index++;
+         max_iter = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-tol") == 0 )
+      {
+         arg_index++;
+         tol = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-storage") == 0 )
+      {
+         arg_index++;
+         storage = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-fmg") == 0 )
+      {
+         arg_index++;
+         fmg = 1;
+      }
+      else if ( strcmp(argv[arg_index], "-vsize") == 0 )
+      {
+         arg_index++;
+         vsize = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-msize") == 0 )
+      {
+         arg_index++;
+         msize = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-lambda") == 0 )
+      {
+         arg_index++;
+         lambda = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-nonlin") == 0 )
+      {
+         arg_index++;
+         alpha = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-busy") == 0 )
+      {
+         arg_index++;
+         busy = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-cscale") == 0 )
+      {
+         arg_index++;
+         cscale = atof(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-stream") == 0 )
+      {
+         arg_index++;
+         stream = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-wsize") == 0 )
+      {
+         arg_index++;
+         wsize = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-reps") == 0 )
+      {
+         arg_index++;
+         reps = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-format") == 0 )
+      {
+         arg_index++;
+         json = (strcmp(argv[arg_index++], "json") == 0);
+      }
+      else if ( strcmp(argv[arg_index], "-header") == 0 )
+      {
+         arg_index++;
+         header = 1;
+      }
+      else
+      {
+         if (rank == 0)
+         {
+            printf("ABORTING: incorrect command line parameter %s\n", argv[arg_index]);
+         }
+         MPI_Finalize();
+         return (1);
+      }
+   }
+
+   ntime = (ntpr > 0) ? ntpr*nprocs : nt;
+   vsize = (vsize < 1) ? 1 : vsize;
+   msize = (msize < vsize) ? vsize : msize;
+   reps  = (reps < 1) ? 1 : reps;
+   tstart = 0.0;
+   tstop  = tstart + ntime/100.0;
+
+   /* Set up the application structure */
+   app = (my_App *) malloc(sizeof(my_App));
+   (app->rank)   = rank;
+   (app->vsize)  = vsize;
+   (app->msize)  = msize;
+   (app->lambda) = lambda;
+   (app->alpha)  = alpha;
+   (app->busy)   = busy*1.0e-6;
+   (app->cscale) = cscale;
+   (app->stream) = stream;
+   (app->wsize)  = (stream > 0) ? wsize : 0;
+   (app->sink)   = 0.0;
+   for (i = 0; i < 3; i++)
+   {
+      (app->work)[i] = (double *) malloc(((app->wsize) + 1)*sizeof(double));
+      memset((app->work)[i], 0, ((app->wsize) + 1)*sizeof(double));
+   }
+
+   tmin = tsum = 0.0;
+   rnorm = 0.0;
+   for (rep = 0; rep < reps; rep++)
+   {
+      (app->nsteps)  = 0.0;
+      (app->nsolves) = 0.0;
+      (app->nbytes)  = 0.0;
+      (app->nmsgs)   = 0.0;
+
+      braid_Init(MPI_COMM_WORLD, comm, tstart, tstop, ntime, app,
+                 my_Step, my_Init, my_Clone, my_Free, my_Sum, my_SpatialNorm,
+                 my_Access, my_BufSize, my_BufPack, my_BufUnpack, &core);
+
+      /* Keep XBraid messages out of the results */
+      braid_SetPrintFile(core, "braid-bench.log");
+      braid_SetPrintLevel(core, 0);
+      braid_SetAccessLevel(core, 0);
+      braid_SetMaxLevels(core, max_levels);
+      braid_SetMinCoarse(core, min_coarse);
+      braid_SetNRelax(core, -1, nrelax);
+      braid_SetAbsTol(core, tol);
+      braid_SetCFactor(core, -1, cfactor);
+      braid_SetMaxIter(core, max_iter);
+      braid_SetStorage(core, storage);
+      if (fmg)
+      {
+         braid_SetFMG(core);
+      }
+
+      MPI_Barrier(comm);
+      time = MPI_Wtime();
+      braid_Drive(core);
+      time = MPI_Wtime() - time;
+      MPI_Allreduce(&time, &gcounts[0], 1, MPI_DOUBLE, MPI_MAX, comm);
+      time = gcounts[0];
+
+      tsum += time;
+      if ((rep == 0) || (time < tmin))
+      {
+         tmin = time;
+      }
+
+      braid_GetNumIter(core, &niter);
+      braid_GetNLevels(core, &nlevels);
+      i = -1;
+      braid_GetRNorms(core, &i, &rnorm);
+      if (i < 1)
+      {
+         rnorm = -1.0;
+      }
+      braid_Destroy(core);
+
+      /* Counters are the same for every repetition */
+      counts[0] = (app->nsteps);
+      counts[1] = (app->nsolves);
+      counts[2] = (app->nbytes);
+      counts[3] = (app->nmsgs);
+      counts[4] = (app->sink);
+      MPI_Allreduce(counts, gcounts, 5, MPI_DOUBLE, MPI_SUM, comm);
+      steps  = gcounts[0];
+      solves = gcounts[1];
+      bytes  = gcounts[2];
+      msgs   = gcounts[3];
+   }
+
+   if (rank == 0)
+   {
+      if (json)
+      {
+         printf("{\"nprocs\": %d, \"ntime\": %d, \"max_levels\": %d, \"nlevels\": %d, "
+                "\"cfactor\": %d, \"nrelax\": %d, \"storage\": %d, \"fmg\": %d, "
+                "\"vsize\": %d, \"msize\": %d, \"busy_us\": %g, \"stream\": %d, "
+                "\"nonlin\": %g, \"niter\": %d, \"rnorm\": %.6e, \"time\": %.6e, "
+                "\"time_avg\": %.6e, \"time_per_iter\": %.6e, \"steps_per_sec\": %.6e, "
+                "\"work_steps\": %.0f, \"newton_iters\": %.0f, \"bytes_sent\": %.0f, "
+                "\"msgs_sent\": %.0f}\n",
+                nprocs, ntime, max_levels, nlevels, cfactor, nrelax, storage, fmg,
+                vsize, msize, busy, stream, alpha, niter, rnorm, tmin, tsum/reps,
+                tmin/((niter > 0) ? niter : 1), ntime/tmin, steps, solves, bytes, msgs);
+      }
+      else
+      {
+         if (header)
+         {
+            printf("nprocs,ntime,max_levels,nlevels,cfactor,nrelax,storage,fmg,"
+                   "vsize,msize,busy_us,stream,nonlin,niter,rnorm,time,time_avg,"
+                   "time_per_iter,steps_per_sec,work_steps,newton_iters,bytes_sent,"
+                   "msgs_sent\n");
+         }
+         printf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%g,%d,%g,%d,%.6e,%.6e,%.6e,%.6e,"
+                "%.6e,%.0f,%.0f,%.0f,%.0f\n",
+                nprocs, ntime, max_levels, nlevels, cfactor, nrelax, storage, fmg,
+                vsize, msize, busy, stream, alpha, niter, rnorm, tmin, tsum/reps,
+                tmin/((niter > 0) ? niter : 1), ntime/tmin, steps, solves, bytes, msgs);
+      }
+      fflush(stdout);
+   }
+
+   for (i = 0; i < 3; i++)
+   {
+      free((app->work)[i]);
+   }
+   free(app);
+
+   MPI_Finalize();
+
+   return (0);
+}
@@ -0,0 +1,549 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory. Written by
+ * Jacob Schroder, Rob Falgout, Tzanio Kolev, Ulrike Yang, Veselin
+ * Dobrev, et al. LLNL-CODE-660355. All rights reserved.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+/**
+ * Benchmark:     braid-overhead.c
+ *
+ * Interface:     C
+ *
+ * Requires:      only C-language support
+ *
+ * Compile with:  make braid-overhead   (or make sequential=yes braid-overhead)
+ *
+ * Help with:     braid-overhead -help
+ *
+ * Sample run:    mpirun -np 4 braid-overhead -nt 65536 -format json
+ *
+ * Description:   measures the time XBraid itself spends per time step, with
+ *                user routines that do O(1) work on a scalar.  Every user
+ *                routine takes a time stamp on entry and exit, and the time
+ *                between leaving one user routine and entering the next is
+ *                framework time.  It is charged to the level of the most
+ *                recent step, so the results split the framework overhead by
+ *                level.  The time before each BufPack() is the send side cost
+ *                of a message (finding the processor, allocating the buffer,
+ *                etc.), and the time before each BufUnpack() is the receive
+ *                side cost, including any wait for the message.  Vector
+ *                allocations and frees are counted as well; each also
+ *                allocates or frees one XBraid BaseVector wrapper.
+ *
+ *                Results are summed over all processors and repetitions, and
+ *                printed on processor 0 as one CSV line per level plus a line
+ *                for all levels (level -1), or as one JSON object.
+ **/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "braid.h"
+
+/*--------------------------------------------------------------------------
+ * Per-level statistics
+ *--------------------------------------------------------------------------*/
+
+#define STAT_STEPS     0   /* time steps */
+#define STAT_TIME      1   /* framework time */
+#define STAT_PACKS     2   /* messages packed */
+#define STAT_PACKTIME  3   /* framework time before packing */
+#define STAT_UNPACKS   4   /* messages unpacked */
+#define STAT_UNPACKTIME 5  /* framework time before unpacking */
+#define STAT_ALLOCS    6   /* vector allocations */
+#define STAT_FREES     7   /* vector frees */
+#define STAT_NSTATS    8
+
+/*--------------------------------------------------------------------------
+ * User-defined routines and structures
+ *--------------------------------------------------------------------------*/
+
+typedef struct _braid_App_struct
+{
+   int       rank;
+   int       nlevels;     /* number of levels with statistics */
+   int       level;       /* level of the most recent step */
+   int       active;      /* measure framework time only inside braid_Drive */
+   double    tlast;       /* time when the last user routine returned */
+   double    tenter;      /* time when the current user routine was entered */
+   double    incall;      /* total time spent in user routines */
+   double   *stats;       /* STAT_NSTATS values per level */
+} my_App;
+
+typedef struct _braid_Vector_struct
+{
+   double value;
+} my_Vector;
+
+/* Charge the time since the last user routine returned to the current level,
+ * and to the message statistic with index 'stat' if it is nonnegative */
+static void
+my_Enter(braid_App  app,
+         int        level,
+         int        stat)
+{
+   double  *stats;
+   double   t, gap;
+
+   t = MPI_Wtime();
+   gap = (app->active) ? t - (app->tlast) : 0.0;
+   if (level >= 0)
+   {
+      (app->level) = (level < (app->nlevels)) ? level : (app->nlevels)-1;
+   }
+   stats = (app->stats) + STAT_NSTATS*(app->level);
+   stats[STAT_TIME] += gap;
+   if (stat >= 0)
+   {
+      stats[stat]   += 1.0;
+      stats[stat+1] += gap;
+   }
+   (app->tenter) = t;
+}
+
+static void
+my_Leave(braid_App  app)
+{
+   double  t;
+
+   t = MPI_Wtime();
+   if (app->active)
+   {
+      (app->incall) += t - (app->tenter);
+   }
+   (app->tlast) = t;
+}
+
+static void
+my_Count(braid_App  app,
+         int        stat)
+{
+   (app->stats)[STAT_NSTATS*(app->level) + stat] += 1.0;
+}
+
+int
+my_Step(braid_App        app,
+        braid_Vector     ustop,
+        braid_Vector     fstop,
+        braid_Vector     u,
+        braid_StepStatus status)
+{
+   int  level;
+
+   braid_StepStatusGetLevel(status, &level);
+   my_Enter(app, level, -1);
+   my_Count(app, STAT_STEPS);
+
+   (u->value) = 0.5*(u->value);
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_Init(braid_App     app,
+        double        t,
+        braid_Vector *u_ptr)
+{
+   my_Vector *u;
+
+   my_Enter(app, -1, -1);
+   my_Count(app, STAT_ALLOCS);
+
+   u = (my_Vector *) malloc(sizeof(my_Vector));
+   (u->value) = (t == 0.0) ? 1.0 : 0.456;
+   *u_ptr = u;
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_Clone(braid_App     app,
+         braid_Vector  u,
+         braid_Vector *v_ptr)
+{
+   my_Vector *v;
+
+   my_Enter(app, -1, -1);
+   my_Count(app, STAT_ALLOCS);
+
+   v = (my_Vector *) malloc(sizeof(my_Vector));
+   (v->value) = (u->value);
+   *v_ptr = v;
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_Free(braid_App    app,
+        braid_Vector u)
+{
+   my_Enter(app, -1, -1);
+   my_Count(app, STAT_FREES);
+
+   free(u);
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_Sum(braid_App     app,
+       double        alpha,
+       braid_Vector  x,
+       double        beta,
+       braid_Vector  y)
+{
+   my_Enter(app, -1, -1);
+
+   (y->value) = alpha*(x->value) + beta*(y->value);
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_SpatialNorm(braid_App     app,
+               braid_Vector  u,
+               double       *norm_ptr)
+{
+   my_Enter(app, -1, -1);
+
+   *norm_ptr = fabs(u->value);
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_Access(braid_App          app,
+          braid_Vector       u,
+          braid_AccessStatus astatus)
+{
+   return 0;
+}
+
+int
+my_BufSize(braid_App          app,
+           int                *size_ptr,
+           braid_BufferStatus bstatus)
+{
+   *size_ptr = sizeof(double);
+   return 0;
+}
+
+int
+my_BufPack(braid_App          app,
+           braid_Vector       u,
+           void               *buffer,
+           braid_BufferStatus bstatus)
+{
+   my_Enter(app, -1, STAT_PACKS);
+
+   *((double *) buffer) = (u->value);
+   braid_BufferStatusSetSize( bstatus, sizeof(double) );
+
+   my_Leave(app);
+   return 0;
+}
+
+int
+my_BufUnpack(braid_App          app,
+             void               *buffer,
+             braid_Vector       *u_ptr,
+             braid_BufferStatus bstatus)
+{
+   my_Vector *u;
+
+   my_Enter(app, -1, STAT_UNPACKS);
+   my_Count(app, STAT_ALLOCS);
+
+   u = (my_Vector *) malloc(sizeof(my_Vector));
+   (u->value) = *((double *) buffer);
+   *u_ptr = u;
+
+   my_Leave(app);
+   return 0;
+}
+
+/*--------------------------------------------------------------------------
+ * Print the statistics s for one level (-1 for all levels)
+ *--------------------------------------------------------------------------*/
+
+static void
+print_level(int      json,
+            int      nprocs,
+            int      ntime,
+            int      nlevels,
+            int      niter,
+            int      level,
+            double  *s)
+{
+   double  steps   = (s[STAT_STEPS] > 0.0) ? s[STAT_STEPS] : 1.0;
+   double  packs   = (s[STAT_PACKS] > 0.0) ? s[STAT_PACKS] : 1.0;
+   double  unpacks = (s[STAT_UNPACKS] > 0.0) ? s[STAT_UNPACKS] : 1.0;
+
+   if (json)
+   {
+      printf("{\"level\": %d, \"steps\": %.0f, \"framework_time\": %.6e, "
+             "\"us_per_step\": %.4f, \"msgs_sent\": %.0f, \"us_per_send\": %.4f, "
+             "\"msgs_recv\": %.0f, \"us_per_recv\": %.4f, \"vec_allocs\": %.0f, "
+             "\"vec_frees\": %.0f, \"allocs_per_step\": %.4f}",
+             level, s[STAT_STEPS], s[STAT_TIME], 1.0e6*s[STAT_TIME]/steps,
+             s[STAT_PACKS], 1.0e6*s[STAT_PACKTIME]/packs,
+             s[STAT_UNPACKS], 1.0e6*s[STAT_UNPACKTIME]/unpacks,
+             s[STAT_ALLOCS], s[STAT_FREES], s[STAT_ALLOCS]/steps);
+   }
+   else
+   {
+      printf("%d,%d,%d,%d,%d,%.0f,%.6e,%.4f,%.0f,%.4f,%.0f,%.4f,%.0f,%.0f,%.4f\n",
+             nprocs, ntime, nlevels, niter, level,
+             s[STAT_STEPS], s[STAT_TIME], 1.0e6*s[STAT_TIME]/steps,
+             s[STAT_PACKS], 1.0e6*s[STAT_PACKTIME]/packs,
+             s[STAT_UNPACKS], 1.0e6*s[STAT_UNPACKTIME]/unpacks,
+             s[STAT_ALLOCS], s[STAT_FREES], s[STAT_ALLOCS]/steps);
+   }
+}
+
+/*--------------------------------------------------------------------------
+ * Main driver
+ *--------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+   braid_Core  core;
+   my_App     *app;
+   MPI_Comm    comm;
+   double      tstart, tstop, time, wall, incall, *gstats, total[STAT_NSTATS];
+   int         rank, nprocs, arg_index, rep, level, i;
+   int         nlevels = 0, niter = 0;
+
+   /* Benchmark parameters */
+   int         ntime       = 65536;
+   int         max_levels  = 30;
+   int         min_coarse  = 2;
+   int         cfactor     = 2;
+   int         nrelax      = 1;
+   int         max_iter    = 10;
+   int         storage     = -1;
+   int         reps        = 1;
+   int         json        = 0;
+   int         header      = 0;
+
+   /* Initialize MPI */
+   MPI_Init(&argc, &argv);
+   comm   = MPI_COMM_WORLD;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &nprocs);
+
+   /* Parse command line */
+   arg_index = 1;
+   while (arg_index < argc)
+   {
+      if ( strcmp(argv[arg_index], "-help") == 0 )
+      {
+         if ( rank == 0 )
+         {
+            printf("\n");
+            printf(" XBraid framework overhead benchmark, see the top of braid-overhead.c\n\n");
+            printf("   -nt   <ntime>        : set num points in time (default: 65536)\n");
+            printf("   -ml   <max_levels>   : set max levels (default: 30)\n");
+            printf("   -mc   <min_coarse>   : set min possible coarse level size (default: 2)\n");
+            printf("   -cf   <cfactor>      : set coarsening factor on all levels (default: 2)\n");
+            printf("   -nu   <nrelax>       : set num F-C relaxations (default: 1)\n");
+            printf("   -mi   <max_iter>     : set the number of iterations (default: 10)\n");
+            printf("   -storage <level>     : set full storage levels (default: -1)\n\n");
+            printf("   -reps <r>            : repeat the solve r times (default: 1)\n");
+            printf("   -format <csv|json>   : set the output format (default: csv)\n");
+            printf("   -header              : print the CSV header line first\n\n");
+         }
+         MPI_Finalize();
+         return (0);
+      }
+      else if ( strcmp(argv[arg_index], "-nt") == 0 )
+      {
+         arg_index++;
+         ntime = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-ml") == 0 )
+      {
+         arg_index++;
+         max_levels = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mc") == 0 )
+      {
+         arg_index++;
+         min_coarse = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-cf") == 0 )
+      {
+         arg_index++;
+         cfactor = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-nu") == 0 )
+      {
+         arg_index++;
+         nrelax = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-mi") == 0 )
+      {
+         arg_index++;
+         max_iter = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-storage") == 0 )
+      {
+         arg_index++;
+         storage = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-reps") == 0 )
+      {
+         arg_index++;
+         reps = atoi(argv[arg_index++]);
+      }
+      else if ( strcmp(argv[arg_index], "-format") == 0 )
+      {
+         arg_index++;
+         json = (strcmp(argv[arg_index++], "json") == 0);
+      }
+      else if ( strcmp(argv[arg_index], "-header") == 0 )
+      {
+         arg_index++;
+         header = 1;
+      }
+      else
+      {
+         if (rank == 0)
+         {
+            printf("ABORTING: incorrect command line parameter %s\n", argv[arg_index]);
+         }
+         MPI_Finalize();
+         return (1);
+      }
+   }
+
+   max_levels = (max_levels < 1) ? 1 : max_levels;
+   reps = (reps < 1) ? 1 : reps;
+   tstart = 0.0;
+   tstop  = tstart + ntime/100.0;
+
+   /* Set up the application structure */
+   app = (my_App *) malloc(sizeof(my_App));
+   (app->rank)    = rank;
+   (app->nlevels) = max_levels;
+   (app->level)   = 0;
+   (app->active)  = 0;
+   (app->incall)  = 0.0;
+   (app->stats)   = (double *) calloc(STAT_NSTATS*max_levels, sizeof(double));
+
+   wall = 0.0;
+   for (rep = 0; rep < reps; rep++)
+   {
+      braid_Init(MPI_COMM_WORLD, comm, tstart, tstop, ntime, app,
+                 my_Step, my_Init, my_Clone, my_Free, my_Sum, my_SpatialNorm,
+                 my_Access, my_BufSize, my_BufPack, my_BufUnpack, &core);
+
+      /* Keep XBraid messages out of the results */
+      braid_SetPrintFile(core, "braid-overhead.log");
+      braid_SetPrintLevel(core, 0);
+      braid_SetAccessLevel(core, 0);
+      braid_SetMaxLevels(core, max_levels);
+      braid_SetMinCoarse(core, min_coarse);
+      braid_SetNRelax(core, -1, nrelax);
+      braid_SetAbsTol(core, 0.0);
+      braid_SetCFactor(core, -1, cfactor);
+      braid_SetMaxIter(core, max_iter);
+      braid_SetStorage(core, storage);
+
+      MPI_Barrier(comm);
+      (app->level)  = 0;
+      (app->active) = 1;
+      (app->tlast)  = time = MPI_Wtime();
+      braid_Drive(core);
+      my_Enter(app, -1, -1);
+      (app->active) = 0;
+      wall += (app->tenter) - time;
+
+      braid_GetNumIter(core, &niter);
+      braid_GetNLevels(core, &nlevels);
+      braid_Destroy(core);
+   }
+
+   /* Sum over processors */
+   gstats = (double *) malloc(STAT_NSTATS*max_levels*sizeof(double));
+   MPI_Allreduce((app->stats), gstats, STAT_NSTATS*max_levels, MPI_DOUBLE, MPI_SUM, comm);
+   MPI_Allreduce(&wall, &time, 1, MPI_DOUBLE, MPI_SUM, comm);
+   wall = time;
+   MPI_Allreduce(&(app->incall), &incall, 1, MPI_DOUBLE, MPI_SUM, comm);
+   for (i = 0; i < STAT_NSTATS; i++)
+   {
+      total[i] = 0.0;
+      for (level = 0; level < max_levels; level++)
+      {
+         total[i] += gstats[STAT_NSTATS*level + i];
+      }
+   }
+
+   if (rank == 0)
+   {
+      nlevels = (nlevels < max_levels) ? nlevels : max_levels;
+      if (json)
+      {
+         printf("{\"nprocs\": %d, \"ntime\": %d, \"nlevels\": %d, \"niter\": %d, "
+                "\"reps\": %d, \"drive_time\": %.6e, \"user_time\": %.6e, \"levels\": [",
+                nprocs, ntime, nlevels, niter, reps, wall, incall);
+         for (level = 0; level < nlevels; level++)
+         {
+            print_level(json, nprocs, ntime, nlevels, niter, level,
+                        gstats + STAT_NSTATS*level);
+            printf(", ");
+         }
+         print_level(json, nprocs, ntime, nlevels, niter, -1, total);
+         printf("]}\n");
+      }
+      else
+      {
+         if (header)
+         {
+            printf("nprocs,ntime,nlevels,niter,level,steps,framework_time,us_per_step,"
+                   "msgs_sent,us_per_send,msgs_recv,us_per_recv,vec_allocs,vec_frees,"
+                   "allocs_per_step\n");
+         }
+         for (level = 0; level < nlevels; level++)
+         {
+            print_level(json, nprocs, ntime, nlevels, niter, level,
+                        gstats + STAT_NSTATS*level);
+         }
+         print_level(json, nprocs, ntime, nlevels, niter, -1, total);
+      }
+      fflush(stdout);
+   }
+
+   free(gstats);
+   free(app->stats);
+   free(app);
+
+   MPI_Finalize();
+
+   return (0);
+}
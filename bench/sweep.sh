@@ -0,0 +1,99 @@
+#!/bin/bash
+#BHEADER**********************************************************************
+#
+# Copyright (c) 2013, Lawrence Livermore National Security, LLC. 
+# Produced at the Lawrence Livermore National Laboratory. Written by 
+# Jacob Schroder, Rob Falgout, Tzanio Kolev, Ulrike Yang, Veselin 
+# Dobrev, et al. LLNL-CODE-660355. All rights reserved.
+# 
+# This file is part of XBraid. For support, post issues to the XBraid Github page.
+# 
+# This program is free software; you can redistribute it and/or modify it under
+# the terms of the GNU General Public License (as published by the Free Software
+# Foundation) version 2.1 dated February 1999.
+# 
+# This program is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+# PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+# License for more details.
+# 
+# You should have received a copy of the GNU Lesser General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc., 59
+# Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+#EHEADER**********************************************************************
+
+# Echo usage information
+case $1 in
+   -h|-help)
+      cat <<EOF2
+
+   $0 [-h|-help] [strong|weak] [braid-bench options]
+
+   where: -h|-help   prints this usage information and exits
+          strong     keeps the total number of time points fixed (-nt, default)
+          weak       keeps the number of time points per processor fixed (-ntpr)
+
+   This script runs braid-bench over all combinations of the processor
+   counts, maximum levels, coarsening factors and storage modes given by the
+   environment variables below, and writes one CSV line per run to stdout.
+   Any remaining arguments are passed to every braid-bench run.
+
+      NPROCS    processor counts               (default: "1 2 4")
+      LEVELS    maximum numbers of levels      (default: "1 2 30")
+      CFACTORS  coarsening factors             (default: "2 4 8")
+      STORAGES  storage modes                  (default: "-1 0")
+      NT        time points, strong scaling    (default: 4096)
+      NTPR      time points per proc, weak     (default: 1024)
+      MPIRUN    launcher, "" for sequential    (default: "mpirun -np")
+
+   Example usage: $0 strong -busy 50 -vsize 1000 > strong.csv
+                  NPROCS=1 MPIRUN= $0 weak -stream 1 -wsize 100000
+
+EOF2
+      exit
+      ;;
+esac
+
+scaling=strong
+case $1 in
+   strong|weak)
+      scaling=$1
+      shift
+      ;;
+esac
+
+bench=`dirname $0`/braid-bench
+NPROCS=${NPROCS-"1 2 4"}
+LEVELS=${LEVELS-"1 2 30"}
+CFACTORS=${CFACTORS-"2 4 8"}
+STORAGES=${STORAGES-"-1 0"}
+NT=${NT-4096}
+NTPR=${NTPR-1024}
+MPIRUN=${MPIRUN-"mpirun -np"}
+
+header="-header"
+for np in $NPROCS
+do
+   if [ -n "$MPIRUN" ] ; then
+      RunString="$MPIRUN $np"
+   else
+      RunString=""
+   fi
+   if [ "$scaling" = "weak" ] ; then
+      size="-ntpr $NTPR"
+   else
+      size="-nt $NT"
+   fi
+   for ml in $LEVELS
+   do
+      for cf in $CFACTORS
+      do
+         for st in $STORAGES
+         do
+            $RunString $bench $size -ml $ml -cf $cf -storage $st $header $*
+            header=""
+         done
+      done
+   done
+done
@@ -142,6 +142,9 @@ struct _braid_BaseVector_struct
 {
    braid_Vector    userVector;      /**< holds the users primal vector */
    braid_VectorBar bar;             /**< holds the bar vector (shared pointer implementation) */
+   braid_Real      mem_size;        /**< estimated size in bytes, counted in the memory statistics (see memory.c) */
+   braid_Int       mem_level;       /**< level the vector is counted on */
+   braid_Int       mem_role;        /**< role the vector is counted as (braid_MEM_UA, ...) */
 };
 typedef struct _braid_BaseVector_struct *braid_BaseVector;
 
@@ -168,6 +171,91 @@ struct _braid_Optimization_struct
 };
 typedef struct _braid_Optimization_struct *braid_Optim;
 
+/** 
+ * Data structure for the outer (Anderson) acceleration history, see accel.c
+ */
+typedef struct
+{
+   braid_Int          nc;               /**< number of level-0 C-points on this processor (without the initial condition) */
+   braid_Int         *cindex;           /**< time index of each of these C-points */
+   braid_Int          niter;            /**< number of times _braid_Accelerate() was called */
+   braid_Int          nhist;            /**< number of differences currently kept (at most accel_depth) */
+   braid_Int          head;             /**< ring slot for the next difference */
+   braid_BaseVector  *x;                /**< last iterate at each C-point */
+   braid_BaseVector  *f;                /**< last cycle residual g - x at each C-point */
+   braid_BaseVector  *g;                /**< last cycle output at each C-point */
+   braid_BaseVector  *dF;               /**< differences of f, accel_depth slots of nc vectors */
+   braid_BaseVector  *dG;               /**< differences of g, accel_depth slots of nc vectors */
+   braid_Real        *gram;             /**< Gram matrix of the dF slots (accel_depth x accel_depth) */
+} _braid_Accel;
+
+/** 
+ * Data structure for the online auto-tuner, see tune.c
+ */
+typedef struct
+{
+   braid_Int          phase;            /**< -1: skip a cycle, 0: start a measured cycle, 1: score it, 2: done */
+   braid_Int          ntried;           /**< number of tried configurations (including the initial one) */
+   braid_Int         *configs;          /**< cfactor, nrelax and number of levels of each tried configuration */
+   braid_Real        *scores;           /**< wall time per e-fold residual reduction of each tried configuration */
+   braid_Int          current;          /**< configuration the hierarchy is currently built with */
+   braid_Int          best;             /**< configuration with the lowest score so far */
+   braid_Int          max_levels;       /**< the user's max_levels, upper bound for the number of levels */
+   braid_Real         rprev;            /**< residual norm at the start of the measured cycle */
+   braid_Real         tprev;            /**< wall time at the start of the measured cycle */
+} _braid_Tune;
+
+/**
+ * Event types recorded by the tracer, see trace.c
+ */
+#define _braid_TRACE_STEP       0
+#define _braid_TRACE_SEND       1
+#define _braid_TRACE_WAIT       2
+#define _braid_TRACE_BUFPACK    3
+#define _braid_TRACE_BUFUNPACK  4
+#define _braid_TRACE_COARSEN    5
+#define _braid_TRACE_REFINE     6
+#define _braid_TRACE_FCRELAX    7
+#define _braid_TRACE_FRESTRICT  8
+#define _braid_TRACE_FINTERP    9
+#define _braid_TRACE_CYCLETOP  10
+#define _braid_TRACE_NTYPES    11
+
+/** 
+ * One traced event (a begin/end pair), see trace.c
+ */
+typedef struct
+{
+   braid_Real         start;            /**< begin time in seconds since the trace origin */
+   braid_Real         dur;              /**< duration in seconds */
+   braid_Int          type;             /**< event type (_braid_TRACE_STEP, ...) */
+   braid_Int          level;            /**< grid level (-1 if not applicable) */
+   braid_Int          index;            /**< time index (-1 if not applicable) */
+   braid_Int          iter;             /**< MGRIT iteration */
+} _braid_TraceEvent;
+
+/** 
+ * Data structure for the event timeline, see trace.c
+ */
+typedef struct
+{
+   braid_Int          size;             /**< capacity of the ring buffer */
+   braid_Int          nevents;          /**< number of recorded events, the newest size are kept */
+   _braid_TraceEvent *events;           /**< ring buffer, NULL until the first braid_Drive() */
+   braid_Real         t0;               /**< MPI_Wtime() at the time origin */
+   char              *filename;         /**< name of the Chrome trace (JSON) file */
+} _braid_Trace;
+
+/**
+ * Number of vector roles in the memory statistics (braid_MEM_UA, ...), see
+ * memory.c.  For each level, mem_stats holds the current and peak number of
+ * vectors and bytes (four values) for each role, and then for all roles.
+ * _braid_MemIndex() is the offset of these values in mem_stats, where role
+ * _braid_MEM_NROLES is the level total.
+ */
+#define _braid_MEM_NROLES  6
+#define _braid_MemIndex(level, role)  ( 4*((level)*(_braid_MEM_NROLES+1) + (role)) )
+
 /*--------------------------------------------------------------------------
  * Main data structures and accessor macros
  *--------------------------------------------------------------------------*/
@@ -186,9 +274,21 @@ typedef struct
    MPI_Status       *status;          /**< MPI status */
    void             *buffer;          /**< Buffer for message */
    braid_BaseVector *vector_ptr;      /**< braid_vector being sent/received */
+   braid_Int         encoded;         /**< boolean, message passes through the codec layer (see codec.c) */
+   void             *shm_slot;        /**< shared-memory message slot, NULL if the message goes through MPI */
+   braid_BaseVector *self_msg;        /**< message to myself (grid's self_msg), NULL if the message goes through MPI */
+   braid_Int         level;           /**< grid level of the message (for tracing) */
+   braid_Int         index;           /**< time index of the message (for tracing) */
+   braid_Int         buffer_size;     /**< allocated size of buffer in bytes (for the memory statistics) */
    
 } _braid_CommHandle;
 
+/**
+ * Size in bytes of the header (codec id and uncompressed size) that starts
+ * every message passing through the codec layer
+ **/
+#define _braid_CodecHeaderSize (2*sizeof(braid_Int))
+
 /**
  * XBraid Grid structure for a certain time level
  *
@@ -221,8 +321,36 @@ typedef struct
    braid_Real        *ta_alloc;      /**< original memory allocation for ta */
    braid_BaseVector  *va_alloc;      /**< original memory allocation for va */
    braid_BaseVector  *fa_alloc;      /**< original memory allocation for fa */
+   braid_Int          nalloc;        /**< number of points ta_alloc, va_alloc and fa_alloc have room for */
+   braid_Int          ua_nalloc;     /**< number of u-vectors ua_alloc has room for */
 
    braid_BaseVector   ulast;         /**< stores vector at last time step, only set in FAccess and FCRelax if done is True */
+   braid_BaseVector   self_msg;      /**< vector sent to myself (periodic wrap-around), until it is received */
+
+   /** Initial guess predictor history (see step.c) */
+   braid_BaseVector   pred_u[2];     /**< previous step inputs (extrapolation) or initial guess (correction) */
+   braid_Real         pred_t[2];     /**< time values of pred_u */
+   braid_Int          pred_index[2]; /**< time indices of pred_u (-1: empty) */
+
+   /** Asynchronous relaxation (see _braid_UGetVectorAsync()) */
+   _braid_CommHandle **async_recv;   /**< receives left pending by earlier sweeps, oldest first */
+   braid_Int          async_nrecv;   /**< number of pending receives in async_recv */
+   braid_BaseVector   async_ghost;   /**< newest value received from the left neighbor */
+   braid_BaseVector   async_land;    /**< landing slot for the pending receives */
+   braid_Int          async_nstale;  /**< number of consecutive sweeps that used async_ghost */
+
+   /** Out-of-core or compressed storage of ua (see spill.c), only used on the finest grid */
+   char              *spill_state;     /**< spill state of each u-vector (untracked, resident or spilled), NULL if not spilling */
+   char              *spill_map;       /**< mapped spill file with one slot per u-vector (out-of-core storage) */
+   braid_Int          spill_slotsize;  /**< size in bytes of each slot */
+   void             **spill_data;      /**< compressed copy of each spilled u-vector (compressed storage) */
+   braid_Int         *spill_sizes;     /**< size in bytes of each compressed copy */
+   braid_Real         spill_bytes;     /**< total size in bytes of the compressed copies */
+   void              *spill_buffer;    /**< scratch buffer for packing a u-vector before compression */
+   braid_Int          spill_bufsize;   /**< packed size (BufSize) of a u-vector */
+   char              *spill_ref;       /**< clock reference bit of each u-vector */
+   braid_Int          spill_hand;      /**< clock hand, the next u-vector to consider for spilling */
+   braid_Int          spill_nresident; /**< number of resident u-vectors */
 
 } _braid_Grid;
 
@@ -285,6 +413,8 @@ typedef struct _braid_Core_struct
    braid_Int              fmg;              /**< use FMG cycle */
    braid_Int              nfmg;             /**< number of fmg cycles to do initially before switching to V-cycles */
    braid_Int              nfmg_Vcyc;        /**< number of V-cycle calls at each level in FMG */
+   braid_Int             *gammas;           /**< number of visits to level+1 per visit to each level (0: use gamma_default) */
+   braid_Int              gamma_default;    /**< default number of visits to the next coarser level (1: V-cycle, 2: W-cycle) */
    braid_Int              warm_restart;     /**< boolean, indicates whether this is a warm restart of an existing braid_Core */
    braid_Int              tnorm;            /**< choice of temporal norm */
    braid_Real            *tnorm_a;          /**< local array of residual norms on a proc's interval, used for inf-norm */
@@ -323,6 +453,85 @@ typedef struct _braid_Core_struct
    braid_Real            *dtk;              /**< holds value of sum_{i} dt_i^k for each C-interval */
    braid_Real            *estimate;         /**< holds value of the error estimate at each fine grid point */
 
+   /** Compression of vector messages */
+   braid_Int              compress;          /**< boolean, turns on the codec layer for vector messages */
+   braid_Int             *comp_sizes;        /**< minimum message size (bytes) to compress on each level (-1: off, -2: use default) */
+   braid_Int              comp_size_default; /**< default minimum message size (bytes) to compress (-1: off) */
+   braid_PtFcnCompress    compressfcn;       /**< (optional) user compression routine, replaces the built-in codec */
+   braid_PtFcnDecompress  decompressfcn;     /**< (optional) user decompression routine */
+   braid_Real             comp_stats[3];     /**< local number of messages, raw bytes and sent bytes through the codec */
+   braid_Real             comp_gstats[3];    /**< comp_stats summed over all processors, set at the end of braid_Drive() */
+
+   /** Shared-memory transport between time neighbors on the same node */
+   braid_Int              shmem;             /**< boolean, pass vectors to on-node neighbors through shared memory */
+   MPI_Comm               shm_comm;          /**< communicator of the processors sharing my node */
+   MPI_Win                shm_win;           /**< shared-memory window with one message slot per level on each processor */
+   braid_Int             *shm_ranks;         /**< rank in shm_comm of each processor in comm (-1 if not on my node) */
+   char                 **shm_bases;         /**< base address of the window segment of each processor in shm_comm */
+   braid_Int              shm_nslots;        /**< number of message slots (levels) per processor */
+   braid_Int              shm_slotsize;      /**< size in bytes of each message slot, including its flag header */
+
+   /** Out-of-core or compressed storage of the fine-grid u-vectors */
+   braid_Int              spill;             /**< max number of resident u-vectors on level 0 (0: keep all in memory) */
+   braid_Int              spill_compress;    /**< boolean, keep spilled u-vectors compressed in memory instead of in a file */
+   char                  *spill_dir;         /**< scratch directory for the spill files (NULL: $TMPDIR or .) */
+   braid_Real             spill_stats[4];    /**< local number of u-vectors spilled and reloaded, and of stored u-vectors and their bytes in memory */
+   braid_Real             spill_gstats[4];   /**< spill_stats summed over all processors, set at the end of braid_Drive() */
+
+   /** Checkpoint/restart (see checkpoint.c) */
+   braid_Int              ckpt_interval;     /**< write a checkpoint every ckpt_interval iterations (0: never) */
+   char                  *ckpt_file;         /**< checkpoint file name used by ckpt_interval */
+   braid_Int              ckpt_niter;        /**< iteration to continue from after braid_ReadCheckpoint(), reset by braid_Drive() */
+
+   /** Outer acceleration (see accel.c) */
+   braid_Int              accel_depth;       /**< number of past cycles used by Anderson acceleration (0: off) */
+   _braid_Accel          *accel;             /**< acceleration history, NULL until the first accelerated cycle */
+
+   /** Online auto-tuning of the hierarchy (see tune.c) */
+   braid_Int              tune_max;          /**< max number of trial configurations (0: off) */
+   _braid_Tune           *tune;              /**< tuner state, NULL until the first tuning call */
+   braid_Real            *tune_stats;        /**< local seconds in steps, seconds waiting for receives and number of receives, three per level */
+   braid_Real            *tune_gstats;       /**< tune_stats summed over all processors, set at the end of braid_Drive() */
+
+   /** Asynchronous (stale-tolerant) relaxation */
+   braid_Int              async_stale;       /**< max consecutive relaxation sweeps using a stale neighbor value (0: off) */
+   braid_Real             async_stats[2];    /**< local number of receives in asynchronous sweeps and of stale values used */
+   braid_Real             async_gstats[2];   /**< async_stats summed over all processors, set at the end of braid_Drive() */
+
+   /** Lookahead across MGRIT iterations (see norm.c) */
+   braid_Int              lookahead;         /**< boolean, complete the level 0 residual norm reduction only when the norm is needed */
+   MPI_Request            rnorm_request;     /**< pending residual norm reduction */
+   braid_Real             rnorm_lbuf;        /**< local contribution to the pending reduction */
+   braid_Real             rnorm_gbuf;        /**< result of the pending reduction */
+   braid_Int              rnorm_iter;        /**< iteration of the pending reduction (-1: none) */
+
+   /** Event timeline (see trace.c) */
+   _braid_Trace          *trace;             /**< tracer state, NULL if tracing is off */
+
+   /** Vector lifetime and memory accounting (see memory.c) */
+   braid_PtFcnVectorSize  vsize;             /**< (optional) user function: size of a vector in bytes (NULL: use bufsize) */
+   braid_Real             mem_vsize;         /**< size of a vector from bufsize (-1: not known yet) */
+   braid_Int              mem_nlevels;       /**< number of levels in mem_stats (never shrunk, see braid_SetMaxLevels) */
+   braid_Real            *mem_stats;         /**< local current and peak number of vectors and bytes, per level and role (see _braid_MemIndex) */
+   braid_Real             mem_total[4];      /**< local current and peak number of vectors and bytes over all levels and roles */
+   braid_Real            *mem_gstats;        /**< mem_stats and mem_total, max over all processors, set at the end of braid_Drive() */
+
+   /** Initial guess predictors for implicit steps (see step.c) */
+   braid_Int             *pred_types;        /**< predictor used on each level (-1: use pred_default) */
+   braid_Int              pred_default;      /**< default predictor (braid_PRED_NONE, ...) */
+   braid_Real            *step_stats;        /**< local sum of user-reported solver iterations, number of reporting steps and number of steps, three per level */
+   braid_Real            *step_gstats;       /**< step_stats summed over all processors, set at the end of braid_Drive() */
+
+   /** Ensemble mode (see norm.c) */
+   braid_Int              nmembers;          /**< number of ensemble members in each vector (0: no ensemble) */
+   braid_PtFcnEnsembleNorm ensemble_norm;    /**< computes the spatial norm of each ensemble member */
+   braid_Int             *ens_active;        /**< boolean, member has not converged yet */
+   braid_Int             *ens_niter;         /**< iteration at which each member converged (-1: not yet) */
+   braid_Real            *ens_rnorm;         /**< current residual norm of each member */
+   braid_Real            *ens_rnorm0;        /**< initial residual norm of each member */
+   braid_Real            *ens_lnorm;         /**< local (this processor's) temporal norm accumulation of each member */
+   braid_Real            *ens_snorm;         /**< spatial norms returned by ensemble_norm */
+
    /* Data for adjoint and optimization */
    braid_Optim            optim;             /**< structure that stores optimization variables (objective function, etc.) */ 
    braid_Int              adjoint;           /**< determines if adjoint run is performed (1) or not (0) */
@@ -365,6 +574,7 @@ typedef struct _braid_Core_struct
    braid_Real    old_fine_tolx;    /**< Allows for storing the previously used fine tolerance from GetSpatialAccuracy */
    braid_Int     tight_fine_tolx;  /**< Boolean, indicating whether the tightest fine tolx has been used, condition for halting */
    braid_Int     rfactor;          /**< if set by user, allows for subdivision of this interval for better time accuracy */
+   braid_Int     solver_iters;     /**< if set by user, number of iterations of the implicit solver in this step (-1: not set) */
    /** BufferStatus properties */
    braid_Int    messagetype;       /**< message type, 0: for Step(), 1: for load balancing */
    braid_Int    size_buffer;       /**< if set by user, send buffer will be "size" bytes in length */
@@ -450,6 +660,146 @@ extern FILE *_braid_printfile;
  * Prototypes
  *--------------------------------------------------------------------------*/
 
+/* accel.c */
+
+/**
+ * Replace the level-0 C-point values after an MGRIT cycle by the Anderson
+ * extrapolation from the last accel_depth cycles (collective).
+ */
+braid_Int
+_braid_Accelerate(braid_Core  core);
+
+/**
+ * Free the acceleration history.  It is set up again by the next call to
+ * _braid_Accelerate(), e.g., after the grid is refined.
+ */
+braid_Int
+_braid_AccelDestroy(braid_Core  core);
+
+/* tune.c */
+
+/**
+ * Online auto-tuning step, called at the top of each cycle until the tuner is
+ * done (collective).  Scores the configuration of the last cycle and may
+ * rebuild the hierarchy with the next trial configuration, in which case
+ * *retuned_ptr* is set to 1.
+ */
+braid_Int
+_braid_AutoTune(braid_Core   core,
+                braid_Int   *retuned_ptr);
+
+/**
+ * Sum the per-level timings of the auto-tuner over all processors.
+ */
+braid_Int
+_braid_TuneReduceStats(braid_Core  core);
+
+/**
+ * Free the auto-tuner state.
+ */
+braid_Int
+_braid_TuneDestroy(braid_Core  core);
+
+/* trace.c */
+
+/**
+ * Allocate the event buffer and set the time origin after a barrier on
+ * comm_world, if tracing is on and this was not done yet (collective).
+ */
+braid_Int
+_braid_TraceInit(braid_Core  core);
+
+/**
+ * Set *start_ptr* to the current time if tracing is on, and leave it unchanged
+ * otherwise.  The event is recorded by the matching _braid_TraceEnd().
+ */
+braid_Int
+_braid_TraceBegin(braid_Core   core,
+                  braid_Real  *start_ptr);
+
+/**
+ * Record an event of the given type that started at *start* (see
+ * _braid_TraceBegin), with its level and time index (-1 if not applicable).
+ */
+braid_Int
+_braid_TraceEnd(braid_Core  core,
+                braid_Int   type,
+                braid_Int   level,
+                braid_Int   index,
+                braid_Real  start);
+
+/**
+ * Write the recorded events of all processors to the trace file (collective),
+ * and free the tracer state.
+ */
+braid_Int
+_braid_TraceDestroy(braid_Core  core);
+
+/* memory.c */
+
+/**
+ * Add *nvectors* vectors and *nbytes* bytes (both may be negative) to the
+ * memory statistics of *role* on *level*, and update the peak values.
+ */
+braid_Int
+_braid_MemCount(braid_Core  core,
+                braid_Int   level,
+                braid_Int   role,
+                braid_Int   nvectors,
+                braid_Real  nbytes);
+
+/**
+ * Count a user vector that is not held by a braid_BaseVector, e.g., a copy on
+ * the adjoint tape, with *sign* = 1 when it is created and -1 before it is
+ * freed.
+ */
+braid_Int
+_braid_MemCountVector(braid_Core    core,
+                      braid_Int     level,
+                      braid_Int     role,
+                      braid_Vector  u,
+                      braid_Int     sign);
+
+/**
+ * Count the new vector *u* (a shell if *shell* is 1) that is stored in
+ * *u_ptr*.  Its level and role are found from *u_ptr* if it points into a
+ * grid, otherwise it is counted as a temporary on *level*.
+ */
+braid_Int
+_braid_MemAdd(braid_Core         core,
+              braid_BaseVector   u,
+              braid_BaseVector  *u_ptr,
+              braid_Int          level,
+              braid_Int          shell);
+
+/**
+ * Remove the vector *u* from the memory statistics before it is freed.
+ */
+braid_Int
+_braid_MemRemove(braid_Core        core,
+                 braid_BaseVector  u);
+
+/**
+ * Count the vector in *u_ptr* under the level and role of *u_ptr*, after it
+ * was moved there, e.g., from a temporary into ua.
+ */
+braid_Int
+_braid_MemMove(braid_Core         core,
+               braid_BaseVector  *u_ptr);
+
+/**
+ * Update the size of *u* after its data was freed, keeping the shell.
+ */
+braid_Int
+_braid_MemShell(braid_Core        core,
+                braid_BaseVector  u);
+
+/**
+ * Take the max of the memory statistics over all processors.
+ */
+braid_Int
+_braid_MemReduceStats(braid_Core  core);
+
 /* distribution.c */
 
 /**
@@ -522,12 +872,148 @@ _braid_CommSendInit(braid_Core           core,
 
 /**
  * Block on the comm handle *handle_ptr* until the MPI operation (send or recv)
- * has completed
+ * has completed, or until the message has arrived in the shared-memory slot
  */
 braid_Int
 _braid_CommWait(braid_Core         core,
                _braid_CommHandle **handle_ptr);
 
+/**
+ * Test whether the operation of comm handle *handle* has completed, so that
+ * _braid_CommWait() will not block.  Returns 1 for messages to myself and for
+ * shared-memory messages, which are not tested.
+ */
+braid_Int
+_braid_CommTest(braid_Core          core,
+                _braid_CommHandle  *handle,
+                braid_Int          *flag_ptr);
+
+/**
+ * Set up the shared-memory transport for the current grid hierarchy, with one
+ * message slot per level on each processor.  Processors on the same node (as
+ * determined by MPI_Comm_split_type) then pass vectors by packing directly
+ * into the receiver's slot.  Does nothing unless braid_SetSharedMemory() is
+ * on.  This is collective over the temporal communicator.
+ */
+braid_Int
+_braid_CommShmInit(braid_Core  core);
+
+/**
+ * Free the shared-memory window and communicator (collective)
+ */
+braid_Int
+_braid_CommShmDestroy(braid_Core  core);
+
+/* codec.c */
+
+/**
+ * Returns the minimum message size in bytes *min_size_ptr* for compressing
+ * messages on *level*.  A negative value means that messages on *level* do not
+ * pass through the codec layer.
+ */
+braid_Int
+_braid_CodecGetMinSize(braid_Core  core,
+                       braid_Int   level,
+                       braid_Int  *min_size_ptr);
+
+/**
+ * Increase the buffer size *size_ptr* (in bytes) from the user's bufsize
+ * routine by the codec header size, if messages on *level* pass through the
+ * codec layer.
+ */
+braid_Int
+_braid_CodecBufSize(braid_Core  core,
+                    braid_Int   level,
+                    braid_Int  *size_ptr);
+
+/**
+ * Encode the packed buffer *raw* of *raw_size* bytes into *buffer*, which must
+ * hold at least *raw_size* plus _braid_CodecHeaderSize bytes.  The buffer is
+ * compressed if it is at least as large as the minimum size for *level* and
+ * compression makes it smaller, otherwise it is copied.  The number of bytes
+ * written to *buffer* is returned in *size_ptr*.
+ */
+braid_Int
+_braid_CodecEncode(braid_Core  core,
+                   braid_Int   level,
+                   void       *raw,
+                   braid_Int   raw_size,
+                   void       *buffer,
+                   braid_Int  *size_ptr);
+
+/**
+ * Like _braid_CodecEncode(), but always tries to compress and does not count
+ * toward the message statistics.  Used for compressed storage (see spill.c).
+ */
+braid_Int
+_braid_CodecCompress(braid_Core  core,
+                     void       *raw,
+                     braid_Int   raw_size,
+                     void       *buffer,
+                     braid_Int  *size_ptr);
+
+/**
+ * Decode *buffer* of *size* bytes created by _braid_CodecEncode() or
+ * _braid_CodecCompress() into *raw*, which must be large enough to hold the
+ * packed buffer.  The packed size is returned in *raw_size_ptr*.
+ */
+braid_Int
+_braid_CodecDecode(braid_Core  core,
+                   void       *buffer,
+                   braid_Int   size,
+                   void       *raw,
+                   braid_Int  *raw_size_ptr);
+
+/**
+ * Sum the codec message statistics over all processors (collective).
+ */
+braid_Int
+_braid_CodecReduceStats(braid_Core  core);
+
+/* spill.c */
+
+/**
+ * Set up out-of-core or compressed storage for *grid*, if it is turned on and
+ * *grid* is the finest grid with more u-vectors than may be resident.
+ */
+braid_Int
+_braid_SpillInit(braid_Core    core,
+                 _braid_Grid  *grid);
+
+/**
+ * Unmap the spill file of *grid*, or free its compressed copies, and free the
+ * spill state
+ */
+braid_Int
+_braid_SpillDestroy(braid_Core    core,
+                    _braid_Grid  *grid);
+
+/**
+ * Make sure u-vector *iu* on grid *level* is in memory before it is read,
+ * unpacking it from the spill file or its compressed copy if needed.  Other u-vectors may be spilled
+ * to make room.  Does nothing if *level* is not spilling.
+ */
+braid_Int
+_braid_SpillFetch(braid_Core  core,
+                  braid_Int   level,
+                  braid_Int   iu);
+
+/**
+ * Record that u-vector *iu* on grid *level* was replaced.  Other u-vectors may
+ * be spilled to make room.  Does nothing if *level* is not spilling.
+ */
+braid_Int
+_braid_SpillUpdate(braid_Core  core,
+                   braid_Int   level,
+                   braid_Int   iu);
+
+/**
+ * Sum the spill statistics and the memory held by the fine-grid u-vectors over
+ * all processors (collective).
+ */
+braid_Int
+_braid_SpillReduceStats(braid_Core  core);
+
 /* uvector.c */
 
 /**
@@ -575,6 +1061,32 @@ _braid_UGetVector(braid_Core        core,
                   braid_Int         index,
                   braid_BaseVector *u_ptr);
 
+/**
+ * Asynchronous version of _braid_UGetVector() used by relaxation.  If *index*
+ * is my "receive index" and the message has not arrived yet, the newest value
+ * received earlier is returned instead, at most async_stale times in a row.
+ * The receive is then left pending and completed by a later call.
+ */
+braid_Int
+_braid_UGetVectorAsync(braid_Core        core,
+                       braid_Int         level,
+                       braid_Int         index,
+                       braid_BaseVector *u_ptr);
+
+/**
+ * Wait on the receives left pending by asynchronous relaxation on *grid* and
+ * free the stale-value storage
+ */
+braid_Int
+_braid_UCommAsyncDestroy(braid_Core    core,
+                         _braid_Grid  *grid);
+
+/**
+ * Sum the asynchronous relaxation statistics over all processors (collective)
+ */
+braid_Int
+_braid_UCommAsyncReduceStats(braid_Core  core);
+
 /**
  * Stores the u-vector on grid *level* at point *index*.  If *index* is my "send
  * index", a send is initiated to a neighbor processor.  If *move* is true, the
@@ -661,6 +1173,33 @@ _braid_GetUInit(braid_Core         core,
                 braid_BaseVector   u,
                 braid_BaseVector  *ustop_ptr);
 
+/**
+ * If a predictor is set for *level*, build a better initial guess for the step
+ * to *index* from the default guess *ustop* (see _braid_GetUInit()) and the
+ * predictor history, and update the history.  Returns the new guess in
+ * *upred_ptr*, to be freed by the caller, or NULL if no prediction was made.
+ */
+braid_Int
+_braid_GetUPredict(braid_Core         core,
+                   braid_Int          level,
+                   braid_Int          index,
+                   braid_BaseVector   u,
+                   braid_BaseVector   ustop,
+                   braid_BaseVector  *upred_ptr);
+
+/**
+ * Free the predictor history of a grid
+ */
+braid_Int
+_braid_PredictClean(braid_Core    core,
+                    _braid_Grid  *grid);
+
+/**
+ * Sum the step and solver iteration statistics over all processors (collective)
+ */
+braid_Int
+_braid_StepReduceStats(braid_Core  core);
+
 /* residual.c */
 
 /**
@@ -750,6 +1289,18 @@ _braid_GridInit(braid_Core     core,
                 braid_Int      iupper,
                 _braid_Grid  **grid_ptr);
 
+/**
+ * Reinitialize the grid object in *grid_ptr* for a new index range and level,
+ * keeping its array allocations for reuse.  The vectors on the grid are
+ * destroyed.  If *grid_ptr* is NULL, a new grid is created.
+ */
+braid_Int
+_braid_GridReset(braid_Core     core,
+                 braid_Int      level,
+                 braid_Int      ilower,
+                 braid_Int      iupper,
+                 _braid_Grid  **grid_ptr);
+
 /**
  * Destroy the vectors on *grid*
  */
@@ -784,6 +1335,23 @@ _braid_GetRNorm(braid_Core  core,
                 braid_Int   iter,
                 braid_Real *rnorm_ptr);
 
+/**
+ * Start the reduction over all processors of the local (temporal) residual norm
+ * contribution *rnorm* for the current iteration.  With lookahead, this is an
+ * MPI_Iallreduce that is completed by _braid_RNormWait(), otherwise the rnorm
+ * is set before returning.
+ */
+braid_Int
+_braid_RNormStart(braid_Core  core,
+                  braid_Real  rnorm);
+
+/**
+ * Complete a pending residual norm reduction, if any, and set the rnorm for the
+ * iteration that started it.  This is called by _braid_GetRNorm().
+ */
+braid_Int
+_braid_RNormWait(braid_Core  core);
+
 /**
  * Same as SetRNorm, but sets full residual norm.
  */
@@ -809,6 +1377,25 @@ _braid_ComputeFullRNorm(braid_Core  core,
                         braid_Int   level,
                         braid_Real *return_rnorm);
 
+/**
+ * Ensemble version of the spatial norm of the residual *r* (level 0 only).
+ * Computes the norm of each member and adds it to that member's local temporal
+ * norm.  Returns in *rnorm_ptr* the largest norm over the active members.
+ */
+braid_Int
+_braid_EnsembleSpatialNorm(braid_Core        core,
+                           braid_BaseVector  r,
+                           braid_Real       *rnorm_ptr);
+
+/**
+ * Combine the local temporal norms of all ensemble members over all processors
+ * (one MPI_Allreduce), store each member's residual norm, reset the local
+ * norms, and return in *rnorm_ptr* the largest norm over the active members.
+ */
+braid_Int
+_braid_EnsembleRNorm(braid_Core   core,
+                     braid_Real  *rnorm_ptr);
+
 /**
  * Print out the residual norm for every C-point.
  * Processor 0 gathers all the rnorms and prints them
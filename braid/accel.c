@@ -0,0 +1,415 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing outer acceleration of the MGRIT cycles.
+ *
+ *  One MGRIT cycle maps the level-0 C-point values x_k at the top of the cycle
+ *  to new values g_k = G(x_k).  Anderson acceleration (type II, depth m) keeps
+ *  the last m differences of the cycle residuals f = g - x and of the cycle
+ *  outputs g, solves the small least-squares problem
+ *
+ *     min_gamma || f_k - sum_j gamma_j dF_j ||
+ *
+ *  and continues from x_{k+1} = g_k - sum_j gamma_j dG_j instead of g_k.  For a
+ *  linear problem this is equivalent to GMRES on the MGRIT-preconditioned
+ *  system (as long as no differences are dropped), and it also applies to
+ *  nonlinear problems.
+ *
+ *  Only the user's sum and spatialnorm routines are needed.  Inner products
+ *  are recovered from norms with the polarization identity
+ *
+ *     <x,y> = ( ||x+y||^2 - ||x-y||^2 ) / 4,
+ *
+ *  so the spatial norm must be induced by an inner product (e.g., a discrete
+ *  L2-norm).  All inner products of one iteration are summed over the
+ *  processors with a single MPI_Allreduce.  If the residual norm grows, the
+ *  history is dropped and the plain MGRIT iterate is used (a restart).
+ **/
+
+#include <math.h>
+#include "_braid.h"
+#include "util.h"
+
+/*----------------------------------------------------------------------------
+ * Add the inner product <x,y> to *dot_ptr
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_AccelDot(braid_Core        core,
+                braid_BaseVector  x,
+                braid_BaseVector  y,
+                braid_Real       *dot_ptr)
+{
+   braid_App         app = _braid_CoreElt(core, app);
+   braid_BaseVector  t;
+   braid_Real        np, nm;
+
+   if (x == y)
+   {
+      _braid_BaseSpatialNorm(core, app, x, &np);
+      *dot_ptr += np*np;
+      return _braid_error_flag;
+   }
+
+   _braid_BaseClone(core, app, x, &t);
+   _braid_BaseSum(core, app, 1.0, y, 1.0, t);        /* t = x + y */
+   _braid_BaseSpatialNorm(core, app, t, &np);
+   _braid_BaseSum(core, app, -2.0, y, 1.0, t);       /* t = x - y */
+   _braid_BaseSpatialNorm(core, app, t, &nm);
+   _braid_BaseFree(core, app, t);
+
+   *dot_ptr += 0.25*(np*np - nm*nm);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Solve the n x n system A gamma = b by Gaussian elimination with partial
+ * pivoting (A and b are overwritten).  Returns 1 if A is (numerically)
+ * singular, in which case gamma is not set.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_AccelSolve(braid_Int    n,
+                  braid_Real  *A,
+                  braid_Real  *b,
+                  braid_Real  *gamma)
+{
+   braid_Real  amax, t;
+   braid_Int   i, j, k, p;
+
+   amax = 0.0;
+   for (i = 0; i < n; i++)
+   {
+      amax = _braid_max(amax, fabs(A[i*n+i]));
+   }
+   if (amax == 0.0)
+   {
+      return 1;
+   }
+
+   for (k = 0; k < n; k++)
+   {
+      p = k;
+      for (i = k+1; i < n; i++)
+      {
+         if (fabs(A[i*n+k]) > fabs(A[p*n+k]))
+         {
+            p = i;
+         }
+      }
+      if (fabs(A[p*n+k]) <= 1e-12*amax)
+      {
+         return 1;
+      }
+      if (p != k)
+      {
+         for (j = 0; j < n; j++)
+         {
+            t = A[k*n+j]; A[k*n+j] = A[p*n+j]; A[p*n+j] = t;
+         }
+         t = b[k]; b[k] = b[p]; b[p] = t;
+      }
+      for (i = k+1; i < n; i++)
+      {
+         t = A[i*n+k] / A[k*n+k];
+         for (j = k; j < n; j++)
+         {
+            A[i*n+j] -= t*A[k*n+j];
+         }
+         b[i] -= t*b[k];
+      }
+   }
+   for (k = n-1; k >= 0; k--)
+   {
+      t = b[k];
+      for (j = k+1; j < n; j++)
+      {
+         t -= A[k*n+j]*gamma[j];
+      }
+      gamma[k] = t / A[k*n+k];
+   }
+
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Set up the acceleration history for the current level-0 grid
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_AccelInit(braid_Core  core)
+{
+   _braid_Grid   **grids   = _braid_CoreElt(core, grids);
+   braid_Int       depth   = _braid_CoreElt(core, accel_depth);
+   braid_Int       ilower  = _braid_GridElt(grids[0], ilower);
+   braid_Int       iupper  = _braid_GridElt(grids[0], iupper);
+   braid_Int       cfactor = _braid_GridElt(grids[0], cfactor);
+   _braid_Accel   *accel;
+   braid_Int       i, nc;
+
+   accel = _braid_CTAlloc(_braid_Accel, 1);
+
+   nc = 0;
+   for (i = ilower; i <= iupper; i++)
+   {
+      if (_braid_IsCPoint(i, cfactor) && (i > _braid_CoreElt(core, initiali)))
+      {
+         nc++;
+      }
+   }
+   accel->nc     = nc;
+   accel->cindex = _braid_CTAlloc(braid_Int, nc);
+   nc = 0;
+   for (i = ilower; i <= iupper; i++)
+   {
+      if (_braid_IsCPoint(i, cfactor) && (i > _braid_CoreElt(core, initiali)))
+      {
+         accel->cindex[nc++] = i;
+      }
+   }
+
+   accel->x     = _braid_CTAlloc(braid_BaseVector, nc);
+   accel->f     = _braid_CTAlloc(braid_BaseVector, nc);
+   accel->g     = _braid_CTAlloc(braid_BaseVector, nc);
+   accel->dF    = _braid_CTAlloc(braid_BaseVector, depth*nc);
+   accel->dG    = _braid_CTAlloc(braid_BaseVector, depth*nc);
+   accel->gram  = _braid_CTAlloc(braid_Real, depth*depth);
+   accel->niter = 0;
+   accel->nhist = 0;
+   accel->head  = 0;
+
+   _braid_CoreElt(core, accel) = accel;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_AccelDestroy(braid_Core  core)
+{
+   braid_App       app   = _braid_CoreElt(core, app);
+   _braid_Accel   *accel = _braid_CoreElt(core, accel);
+   braid_Int       depth = _braid_CoreElt(core, accel_depth);
+   braid_Int       c, j;
+
+   if (accel == NULL)
+   {
+      return _braid_error_flag;
+   }
+
+   for (c = 0; c < accel->nc; c++)
+   {
+      if (accel->x[c] != NULL) _braid_BaseFree(core, app, accel->x[c]);
+      if (accel->f[c] != NULL) _braid_BaseFree(core, app, accel->f[c]);
+      if (accel->g[c] != NULL) _braid_BaseFree(core, app, accel->g[c]);
+      for (j = 0; j < depth; j++)
+      {
+         if (accel->dF[j*accel->nc+c] != NULL) _braid_BaseFree(core, app, accel->dF[j*accel->nc+c]);
+         if (accel->dG[j*accel->nc+c] != NULL) _braid_BaseFree(core, app, accel->dG[j*accel->nc+c]);
+      }
+   }
+   _braid_TFree(accel->cindex);
+   _braid_TFree(accel->x);
+   _braid_TFree(accel->f);
+   _braid_TFree(accel->g);
+   _braid_TFree(accel->dF);
+   _braid_TFree(accel->dG);
+   _braid_TFree(accel->gram);
+   _braid_TFree(accel);
+   _braid_CoreElt(core, accel) = NULL;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_Accelerate(braid_Core  core)
+{
+   MPI_Comm          comm  = _braid_CoreElt(core, comm);
+   braid_App         app   = _braid_CoreElt(core, app);
+   braid_Int         depth = _braid_CoreElt(core, accel_depth);
+   _braid_Accel     *accel;
+   braid_BaseVector  g, x;
+   braid_Real        rnorm, rnorm_prev;
+   braid_Real       *dots, *gdots, *A, *scale, *gamma;
+   braid_Int        *slots;
+   braid_Int         nc, nhist, first, n, s, c, i, j, k, restart;
+
+   if (_braid_CoreElt(core, accel) == NULL)
+   {
+      _braid_AccelInit(core);
+   }
+   accel = _braid_CoreElt(core, accel);
+   nc    = accel->nc;
+
+   /* First call: nothing to compare with yet, just remember x = g */
+   if (accel->niter == 0)
+   {
+      for (c = 0; c < nc; c++)
+      {
+         _braid_UGetVector(core, 0, accel->cindex[c], &accel->x[c]);
+      }
+      accel->niter++;
+      return _braid_error_flag;
+   }
+
+   /* Drop the history if the last step made the residual grow */
+   _braid_GetRNorm(core, -1, &rnorm);
+   _braid_GetRNorm(core, -2, &rnorm_prev);
+   restart = ( (rnorm != braid_INVALID_RNORM) && (rnorm_prev != braid_INVALID_RNORM) &&
+               (rnorm > rnorm_prev) );
+   if (restart)
+   {
+      accel->nhist = 0;
+   }
+
+   /* Form f = g - x, and the new differences dF = f - f_prev, dG = g - g_prev
+    * in ring slot s (reusing the vectors of f_prev and g_prev) */
+   s = accel->head;
+   for (c = 0; c < nc; c++)
+   {
+      _braid_UGetVector(core, 0, accel->cindex[c], &g);
+      _braid_BaseClone(core, app, g, &x);
+      _braid_BaseSum(core, app, -1.0, accel->x[c], 1.0, x);     /* x is now f */
+
+      if ( (accel->niter > 1) && !restart )
+      {
+         if (accel->dF[s*nc+c] != NULL) _braid_BaseFree(core, app, accel->dF[s*nc+c]);
+         if (accel->dG[s*nc+c] != NULL) _braid_BaseFree(core, app, accel->dG[s*nc+c]);
+         _braid_BaseSum(core, app, 1.0, x, -1.0, accel->f[c]);
+         _braid_BaseSum(core, app, 1.0, g, -1.0, accel->g[c]);
+         accel->dF[s*nc+c] = accel->f[c];
+         accel->dG[s*nc+c] = accel->g[c];
+      }
+      else
+      {
+         if (accel->f[c] != NULL) _braid_BaseFree(core, app, accel->f[c]);
+         if (accel->g[c] != NULL) _braid_BaseFree(core, app, accel->g[c]);
+      }
+      accel->f[c] = x;
+      accel->g[c] = g;
+   }
+   if ( (accel->niter > 1) && !restart )
+   {
+      accel->head  = (s+1) % depth;
+      accel->nhist = _braid_min(accel->nhist+1, depth);
+   }
+   accel->niter++;
+   nhist = accel->nhist;
+
+   /* Slots in the ring, from the oldest to the newest difference */
+   slots = _braid_CTAlloc(braid_Int, depth);
+   for (i = 0; i < nhist; i++)
+   {
+      slots[i] = (accel->head - nhist + i + depth) % depth;
+   }
+
+   gamma = NULL;
+   if (nhist > 0)
+   {
+      /* Update row s of the Gram matrix of dF and compute <dF_j, f>, with one
+       * global reduction */
+      dots  = _braid_CTAlloc(braid_Real, 2*nhist);
+      gdots = _braid_CTAlloc(braid_Real, 2*nhist);
+      for (c = 0; c < nc; c++)
+      {
+         for (i = 0; i < nhist; i++)
+         {
+            j = slots[i];
+            _braid_AccelDot(core, accel->dF[s*nc+c], accel->dF[j*nc+c], &dots[i]);
+            _braid_AccelDot(core, accel->dF[j*nc+c], accel->f[c], &dots[nhist+i]);
+         }
+      }
+      MPI_Allreduce(dots, gdots, 2*nhist, braid_MPI_REAL, MPI_SUM, comm);
+      for (i = 0; i < nhist; i++)
+      {
+         j = slots[i];
+         accel->gram[s*depth+j] = gdots[i];
+         accel->gram[j*depth+s] = gdots[i];
+      }
+
+      /* Solve the (diagonally scaled) normal equations of the least-squares
+       * problem.  While they are too ill-conditioned, drop the oldest
+       * difference. */
+      A     = _braid_CTAlloc(braid_Real, nhist*nhist);
+      scale = _braid_CTAlloc(braid_Real, nhist);
+      gamma = _braid_CTAlloc(braid_Real, nhist);
+      for (first = 0; first < nhist; first++)
+      {
+         n = nhist - first;
+         for (i = 0; i < n; i++)
+         {
+            scale[i] = accel->gram[slots[first+i]*depth+slots[first+i]];
+            scale[i] = (scale[i] > 0.0) ? 1.0/sqrt(scale[i]) : 0.0;
+         }
+         for (i = 0; i < n; i++)
+         {
+            for (k = 0; k < n; k++)
+            {
+               A[i*n+k] = scale[i]*scale[k]*accel->gram[slots[first+i]*depth+slots[first+k]];
+            }
+            dots[i] = scale[i]*gdots[nhist+first+i];
+         }
+         if (_braid_AccelSolve(n, A, dots, gamma) == 0)
+         {
+            for (i = 0; i < n; i++)
+            {
+               gamma[i] *= scale[i];
+            }
+            break;
+         }
+      }
+      accel->nhist = nhist - first;
+      _braid_TFree(A);
+      _braid_TFree(scale);
+      _braid_TFree(dots);
+      _braid_TFree(gdots);
+   }
+   nhist = accel->nhist;
+
+   /* New iterate x = g - sum_j gamma_j dG_j, stored back into the C-points */
+   for (c = 0; c < nc; c++)
+   {
+      _braid_BaseFree(core, app, accel->x[c]);
+      _braid_BaseClone(core, app, accel->g[c], &x);
+      if (nhist > 0)
+      {
+         for (i = 0; i < nhist; i++)
+         {
+            j = slots[first+i];
+            _braid_BaseSum(core, app, -gamma[i], accel->dG[j*nc+c], 1.0, x);
+         }
+         _braid_USetVector(core, 0, accel->cindex[c], x, 0);
+      }
+      accel->x[c] = x;
+   }
+   _braid_TFree(gamma);
+   _braid_TFree(slots);
+
+   return _braid_error_flag;
+}
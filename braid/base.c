@@ -77,6 +77,8 @@ _braid_BaseStep(braid_Core       core,
       _braid_CoreFcn(core, clone)(app, ustop->userVector, &ustop_copy);  
       _braid_CoreElt(core, userVectorTape) = _braid_TapePush( _braid_CoreElt(core, userVectorTape), u_copy);
       _braid_CoreElt(core, userVectorTape) = _braid_TapePush( _braid_CoreElt(core, userVectorTape), ustop_copy);
+      _braid_MemCountVector(core, level, braid_MEM_TAPE, u_copy, 1);
+      _braid_MemCountVector(core, level, braid_MEM_TAPE, ustop_copy, 1);
 
       /* Copy & push ubar & ustopbar to bar tape */
       _braid_VectorBarCopy(u->bar, &bar_copy);
@@ -124,7 +126,7 @@ _braid_BaseInit(braid_Core        core,
    if (verbose_adj) _braid_printf("%d INIT\n", myid);
 
    /* Allocate the braid_BaseVector */
-   u = (braid_BaseVector) malloc(sizeof(braid_Vector) + sizeof(braid_VectorBar));
+   u = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
    u->userVector = NULL;
    u->bar        = NULL;
 
@@ -155,6 +157,7 @@ _braid_BaseInit(braid_Core        core,
 
    /* Set the return pointer */
    *u_ptr = u;
+   _braid_MemAdd(core, u, u_ptr, 0, 0);
 
    return _braid_error_flag;
 }
@@ -181,7 +184,7 @@ _braid_BaseClone(braid_Core         core,
    if (verbose_adj) _braid_printf("%d: CLONE\n", myid);
 
    /* Allocate the braid_BaseVector */
-   v = (braid_BaseVector) malloc(sizeof(braid_Vector) + sizeof(braid_VectorBar));
+   v = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
    v->userVector  = NULL;
    v->bar = NULL;
 
@@ -217,6 +220,7 @@ _braid_BaseClone(braid_Core         core,
    }
 
    *v_ptr = v;
+   _braid_MemAdd(core, v, v_ptr, u->mem_level, 0);
 
    return _braid_error_flag;
 }
@@ -250,6 +254,7 @@ _braid_BaseFree(braid_Core       core,
    }
  
    /* Free the user's vector */
+   _braid_MemRemove(core, u);
    _braid_CoreFcn(core, free)(app, u->userVector);
 
    if ( adjoint )
@@ -324,6 +329,21 @@ _braid_BaseSpatialNorm(braid_Core        core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_BaseEnsembleNorm(braid_Core        core,
+                        braid_App         app,      
+                        braid_BaseVector  u,    
+                        braid_Real       *norms )
+{
+   /* Compute the spatial norm of each ensemble member */
+   _braid_CoreFcn(core, ensemble_norm)(app, u->userVector, norms);
+
+   return _braid_error_flag;
+}
+
 /*----------------------------------------------------------------------------
  *----------------------------------------------------------------------------*/
 
@@ -415,6 +435,7 @@ _braid_BaseBufPack(braid_Core          core,
    braid_Int        verbose_adj  = _braid_CoreElt(core, verbose_adj);
    braid_Int        record       = _braid_CoreElt(core, record);
    braid_Int        sender       = _braid_CoreElt(core, send_recv_rank);
+   braid_Real       ttime        = 0.0;
 
    if ( verbose_adj ) _braid_printf("%d: BUFPACK\n",  myid );
 
@@ -437,7 +458,9 @@ _braid_BaseBufPack(braid_Core          core,
    }
    
    /* BufPack the user's vector */
+   _braid_TraceBegin(core, &ttime);
    _braid_CoreFcn(core, bufpack)(app, u->userVector, buffer, status);
+   _braid_TraceEnd(core, _braid_TRACE_BUFPACK, -1, -1, ttime);
 
    return _braid_error_flag;
 }
@@ -461,16 +484,19 @@ _braid_BaseBufUnpack(braid_Core          core,
    braid_Int        adjoint      = _braid_CoreElt(core, adjoint);
    braid_Int        record       = _braid_CoreElt(core, record);
    braid_Int        receiver     = _braid_CoreElt(core, send_recv_rank);
+   braid_Real       ttime        = 0.0;
 
    if ( verbose_adj ) _braid_printf("%d: BUFUNPACK\n", myid);
 
    /* Allocate the braid_BaseVector */
-   u = (braid_BaseVector) malloc(sizeof(braid_Vector) + sizeof(braid_VectorBar));
+   u = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
    u->userVector  = NULL;
    u->bar = NULL;
 
    /* BufUnpack the user's vector */
+   _braid_TraceBegin(core, &ttime);
    _braid_CoreFcn(core, bufunpack)(app, buffer, &(u->userVector), status);
+   _braid_TraceEnd(core, _braid_TRACE_BUFUNPACK, -1, -1, ttime);
 
    if ( adjoint )
    {
@@ -501,6 +527,7 @@ _braid_BaseBufUnpack(braid_Core          core,
     }
   
    *u_ptr = u;
+   _braid_MemAdd(core, u, u_ptr, 0, 0);
 
    return _braid_error_flag;
 }
@@ -549,6 +576,7 @@ _braid_BaseObjectiveT(braid_Core             core,
       /* Push a copy of the user's vector to the userVector tape */
       _braid_CoreFcn(core, clone)(app, u->userVector, &u_copy);     // this will accolate memory for the copy!
       _braid_CoreElt(core, userVectorTape) = _braid_TapePush( _braid_CoreElt(core, userVectorTape), u_copy);
+      _braid_MemCountVector(core, level, braid_MEM_TAPE, u_copy, 1);
 
       /* Push a copy of the bar vector to the bar tape */
       _braid_VectorBarCopy(u->bar, &ubar_copy);
@@ -619,12 +647,14 @@ _braid_BaseSCoarsen(braid_Core              core,
 
    if ( verbose_adj ) _braid_printf("%d: SCOARSEN\n", myid);
 
-   cu = (braid_BaseVector) malloc(sizeof(braid_BaseVector));
+   cu = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
+   cu->bar = NULL;
 
    /* Call the users SCoarsen Function */
    _braid_CoreFcn(core, scoarsen)(app, fu->userVector, &(cu->userVector), status);
 
    *cu_ptr = cu;
+   _braid_MemAdd(core, cu, cu_ptr, fu->mem_level, 0);
 
    return _braid_error_flag;
 }
@@ -645,12 +675,14 @@ _braid_BaseSRefine(braid_Core                 core,
 
    if ( verbose_adj ) _braid_printf("%d: SREFINE\n", myid);
 
-   fu = (braid_BaseVector) malloc(sizeof(braid_BaseVector));
+   fu = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
+   fu->bar = NULL;
 
    /* Call the users SRefine */
    _braid_CoreFcn(core, srefine)(app, cu->userVector, &(fu->userVector), status);
 
    *fu_ptr = fu;
+   _braid_MemAdd(core, fu, fu_ptr, cu->mem_level, 0);
 
    return _braid_error_flag;
 }                      
@@ -670,12 +702,14 @@ _braid_BaseSInit(braid_Core        core,
 
    if ( verbose_adj ) _braid_printf("%d: SINIT\n", myid);
 
-   u = (braid_BaseVector) malloc(sizeof(braid_BaseVector));
+   u = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
+   u->bar = NULL;
 
    /* Call the users SInit */
    _braid_CoreFcn(core, sinit)(app, t, &(u->userVector));
 
    *u_ptr = u;
+   _braid_MemAdd(core, u, u_ptr, 0, 1);
 
    return _braid_error_flag;
 }
@@ -696,12 +730,14 @@ _braid_BaseSClone(braid_Core        core,
 
    if ( verbose_adj ) _braid_printf("%d: SCLONE\n", myid);
 
-   v = (braid_BaseVector) malloc(sizeof(braid_BaseVector));
+   v = (braid_BaseVector) malloc(sizeof(struct _braid_BaseVector_struct));
+   v->bar = NULL;
 
    /* Call the users SClone */
    _braid_CoreFcn(core, sclone)(app, u->userVector, &(v->userVector));
 
    *v_ptr = v;
+   _braid_MemAdd(core, v, v_ptr, u->mem_level, 1);
 
    return _braid_error_flag;
 }
@@ -722,6 +758,7 @@ _braid_BaseSFree(braid_Core      core,
 
    /* Call the users sfree */
    _braid_CoreFcn(core, sfree)(app, u->userVector);
+   _braid_MemShell(core, u);
 
    return _braid_error_flag;
 }
@@ -793,6 +830,8 @@ _braid_BaseStep_diff(_braid_Action *action)
    /* Free memory of the primal and bar vectors */
    _braid_VectorBarDelete(core, ubar);
    _braid_VectorBarDelete(core, ustopbar);
+   _braid_MemCountVector(core, level, braid_MEM_TAPE, u, -1);
+   _braid_MemCountVector(core, level, braid_MEM_TAPE, ustop, -1);
    _braid_CoreFcn(core, free)(app, u);
    _braid_CoreFcn(core, free)(app, ustop);
 
@@ -920,6 +959,7 @@ _braid_BaseObjectiveT_diff(_braid_Action *action)
    _braid_CoreFcn(core, free)(app, userbarCopy);
 
    /* Free primal and bar vectors */
+   _braid_MemCountVector(core, level, braid_MEM_TAPE, u, -1);
    _braid_CoreFcn(core, free)(app, u);
    _braid_VectorBarDelete(core, ubar);
 
@@ -112,6 +112,17 @@ _braid_BaseSpatialNorm(braid_Core        core,      /**< braid_Core structure */
                        braid_Real       *norm_ptr   /**< output, norm of braid_Vector (this is a spatial norm) */
                        );
 
+/**
+ * This calls the user's EnsembleNorm routine. 
+ * If (adjoint): nothing
+ */ 
+braid_Int
+_braid_BaseEnsembleNorm(braid_Core        core,      /**< braid_Core structure */
+                        braid_App         app,       /**< user-defined _braid_App structure */     
+                        braid_BaseVector  u,         /**< vector to norm */
+                        braid_Real       *norms      /**< output, spatial norm of each ensemble member */
+                        );
+
 /**
  * This calls the user's Access routine. 
  * If (adjoint): also record the action
@@ -159,6 +159,9 @@ braid_Drive(braid_Core  core)
    /* Reset from previous calls to braid_drive() */
    _braid_CoreElt(core, done) = 0;
 
+   /* Set the time origin of the event timeline */
+   _braid_TraceInit(core);
+
    /* Solve with MGRIT */
    _braid_Drive(core, localtime);
 
@@ -171,6 +174,36 @@ braid_Drive(braid_Core  core)
    _braid_CoreElt(core, localtime)  = localtime;
    _braid_CoreElt(core, globaltime) = globaltime;
 
+   /* Sum up compression statistics */
+   if ( _braid_CoreElt(core, compress) )
+   {
+      _braid_CodecReduceStats(core);
+   }
+
+   /* Sum up out-of-core and compressed storage statistics */
+   if ( _braid_CoreElt(core, spill) )
+   {
+      _braid_SpillReduceStats(core);
+   }
+
+   /* Sum up asynchronous relaxation statistics */
+   if ( _braid_CoreElt(core, async_stale) )
+   {
+      _braid_UCommAsyncReduceStats(core);
+   }
+
+   /* Sum up step and solver iteration statistics */
+   _braid_StepReduceStats(core);
+
+   /* Max of the memory statistics */
+   _braid_MemReduceStats(core);
+
+   /* Sum up the per-level timings of the auto-tuner */
+   if ( _braid_CoreElt(core, tune_max) )
+   {
+      _braid_TuneReduceStats(core);
+   }
+
    /* Print statistics for this run */
    if ( (print_level > 1) && (myid == 0) )
    {
@@ -297,6 +330,8 @@ braid_Init(MPI_Comm               comm_world,
    _braid_CoreElt(core, fmg)             = fmg;
    _braid_CoreElt(core, nfmg)            = nfmg;
    _braid_CoreElt(core, nfmg_Vcyc)       = nfmg_Vcyc;
+   _braid_CoreElt(core, gammas)          = NULL; /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, gamma_default)   = 1;    /* V-cycles by default */
 
    _braid_CoreElt(core, storage)         = -1;            /* only store C-points */
    _braid_CoreElt(core, useshell)         = 0;
@@ -341,6 +376,7 @@ braid_Init(MPI_Comm               comm_world,
    _braid_CoreElt(core, full_rnorms)         = NULL; /* Set with SetMaxIter() below */
    _braid_CoreElt(core, old_fine_tolx)       = -1.0;
    _braid_CoreElt(core, tight_fine_tolx)     = 1;
+   _braid_CoreElt(core, solver_iters)        = -1;
 
    /* Richardson Error Estimation */
    _braid_CoreElt(core, est_error)       = 0;     /* Error Estimation off by default */
@@ -349,6 +385,76 @@ braid_Init(MPI_Comm               comm_world,
    _braid_CoreElt(core, dtk)             = NULL;  /* Set in _braid_InitHierarchy */
    _braid_CoreElt(core, estimate)        = NULL;  /* Set in _braid_InitHierarchy */
 
+   /* Compression of vector messages */
+   _braid_CoreElt(core, compress)          = 0;     /* Codec layer off by default */
+   _braid_CoreElt(core, comp_sizes)        = NULL;  /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, comp_size_default) = -1;    /* No compression on any level by default */
+   _braid_CoreElt(core, compressfcn)       = NULL;  /* Use the built-in codec by default */
+   _braid_CoreElt(core, decompressfcn)     = NULL;
+
+   /* Shared-memory transport */
+   _braid_CoreElt(core, shmem)             = 0;     /* Shared-memory transport off by default */
+   _braid_CoreElt(core, shm_comm)          = MPI_COMM_NULL;
+   _braid_CoreElt(core, shm_win)           = MPI_WIN_NULL;
+   _braid_CoreElt(core, shm_ranks)         = NULL;  /* Set in _braid_InitHierarchy */
+   _braid_CoreElt(core, shm_bases)         = NULL;
+   _braid_CoreElt(core, shm_nslots)        = 0;
+   _braid_CoreElt(core, shm_slotsize)      = 0;
+
+   /* Out-of-core storage */
+   _braid_CoreElt(core, spill)             = 0;     /* Keep all u-vectors in memory by default */
+   _braid_CoreElt(core, spill_compress)    = 0;
+   _braid_CoreElt(core, spill_dir)         = NULL;  /* Use $TMPDIR by default */
+
+   /* Checkpoint/restart */
+   _braid_CoreElt(core, ckpt_interval)     = 0;     /* No checkpoints by default */
+   _braid_CoreElt(core, ckpt_file)         = NULL;
+   _braid_CoreElt(core, ckpt_niter)        = 0;
+
+   /* Outer acceleration */
+   _braid_CoreElt(core, accel_depth)       = 0;     /* No acceleration by default */
+   _braid_CoreElt(core, accel)             = NULL;
+
+   /* Online auto-tuning */
+   _braid_CoreElt(core, tune_max)          = 0;     /* No tuning by default */
+   _braid_CoreElt(core, tune)              = NULL;
+   _braid_CoreElt(core, tune_stats)        = NULL;  /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, tune_gstats)       = NULL;  /* Set in _braid_TuneReduceStats */
+
+   /* Asynchronous relaxation */
+   _braid_CoreElt(core, async_stale)       = 0;     /* Lock-step relaxation by default */
+
+   /* Lookahead across iterations */
+   _braid_CoreElt(core, lookahead)         = 0;     /* Blocking residual norm reduction by default */
+   _braid_CoreElt(core, rnorm_request)     = MPI_REQUEST_NULL;
+   _braid_CoreElt(core, rnorm_iter)        = -1;    /* No pending reduction */
+
+   /* Event timeline */
+   _braid_CoreElt(core, trace)             = NULL;  /* No tracing by default */
+
+   /* Vector lifetime and memory accounting */
+   _braid_CoreElt(core, vsize)             = NULL;  /* Estimate from bufsize by default */
+   _braid_CoreElt(core, mem_vsize)         = -1.0;  /* Set with the first vector */
+   _braid_CoreElt(core, mem_nlevels)       = 0;
+   _braid_CoreElt(core, mem_stats)         = NULL;  /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, mem_gstats)        = NULL;  /* Set in _braid_MemReduceStats */
+
+   /* Initial guess predictors */
+   _braid_CoreElt(core, pred_types)        = NULL;  /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, pred_default)      = braid_PRED_NONE;
+   _braid_CoreElt(core, step_stats)        = NULL;  /* Set with SetMaxLevels() below */
+   _braid_CoreElt(core, step_gstats)       = NULL;  /* Set in _braid_StepReduceStats */
+
+   /* Ensemble mode */
+   _braid_CoreElt(core, nmembers)          = 0;     /* No ensemble by default */
+   _braid_CoreElt(core, ensemble_norm)     = NULL;
+   _braid_CoreElt(core, ens_active)        = NULL;
+   _braid_CoreElt(core, ens_niter)         = NULL;
+   _braid_CoreElt(core, ens_rnorm)         = NULL;
+   _braid_CoreElt(core, ens_rnorm0)        = NULL;
+   _braid_CoreElt(core, ens_lnorm)         = NULL;
+   _braid_CoreElt(core, ens_snorm)         = NULL;
+
    braid_SetMaxLevels(core, max_levels);
    braid_SetMaxIter(core, max_iter);
    braid_SetPeriodic(core, 0);
@@ -429,13 +535,13 @@ braid_Destroy(braid_Core  core)
       braid_App               app        = _braid_CoreElt(core, app);
       braid_Int               nlevels    = _braid_CoreElt(core, nlevels);
       _braid_Grid           **grids      = _braid_CoreElt(core, grids);
-      braid_Int               cfactor    = _braid_GridElt(grids[0], cfactor);
       braid_Int               gupper     = _braid_CoreElt(core, gupper);
       braid_Int               richardson = _braid_CoreElt(core, richardson);
       braid_Int               est_error  = _braid_CoreElt(core, est_error); 
       braid_Int               level;
 
       _braid_TFree(_braid_CoreElt(core, nrels));
+      _braid_TFree(_braid_CoreElt(core, gammas));
       _braid_TFree(_braid_CoreElt(core, CWts));
       _braid_TFree(_braid_CoreElt(core, rnorms));
       _braid_TFree(_braid_CoreElt(core, full_rnorms));
@@ -443,6 +549,23 @@ braid_Destroy(braid_Core  core)
       _braid_TFree(_braid_CoreElt(core, rfactors));
       _braid_TFree(_braid_CoreElt(core, tnorm_a));
       _braid_TFree(_braid_CoreElt(core, rdtvalues));
+      _braid_TFree(_braid_CoreElt(core, comp_sizes));
+      _braid_TFree(_braid_CoreElt(core, spill_dir));
+      _braid_TFree(_braid_CoreElt(core, ckpt_file));
+      _braid_AccelDestroy(core);
+      _braid_TuneDestroy(core);
+      _braid_TraceDestroy(core);
+      _braid_TFree(_braid_CoreElt(core, tune_stats));
+      _braid_TFree(_braid_CoreElt(core, tune_gstats));
+      _braid_TFree(_braid_CoreElt(core, pred_types));
+      _braid_TFree(_braid_CoreElt(core, step_stats));
+      _braid_TFree(_braid_CoreElt(core, step_gstats));
+      _braid_TFree(_braid_CoreElt(core, ens_active));
+      _braid_TFree(_braid_CoreElt(core, ens_niter));
+      _braid_TFree(_braid_CoreElt(core, ens_rnorm));
+      _braid_TFree(_braid_CoreElt(core, ens_rnorm0));
+      _braid_TFree(_braid_CoreElt(core, ens_lnorm));
+      _braid_TFree(_braid_CoreElt(core, ens_snorm));
 
       /* Destroy the optimization structure */
       _braid_CoreElt(core, record) = 0;
@@ -452,8 +575,10 @@ braid_Destroy(braid_Core  core)
          _braid_TFree(_braid_CoreElt(core, optim));
       }
 
-      /* Free last time step, if set */
-      if ( (_braid_CoreElt(core, storage) < 0) && !(_braid_IsCPoint(gupper, cfactor)) )
+      /* Free last time step, if set (there are no grids if braid_Drive() was
+       * never called, e.g., when only running the braid_Test routines) */
+      if ( (grids[0] != NULL) && (_braid_CoreElt(core, storage) < 0) &&
+           !(_braid_IsCPoint(gupper, _braid_GridElt(grids[0], cfactor))) )
       {
          if (_braid_GridElt(grids[0], ulast) != NULL)
          {
@@ -476,6 +601,12 @@ braid_Destroy(braid_Core  core)
          _braid_GridDestroy(core, grids[level]);
       }
 
+      _braid_CommShmDestroy(core);
+
+      /* Freed after the grids, since freeing their vectors updates these */
+      _braid_TFree(_braid_CoreElt(core, mem_stats));
+      _braid_TFree(_braid_CoreElt(core, mem_gstats));
+
       _braid_TFree(grids);
 
       _braid_TFree(core);
@@ -484,6 +615,7 @@ braid_Destroy(braid_Core  core)
    if (_braid_printfile != NULL)
    {
       fclose(_braid_printfile);
+      _braid_printfile = NULL;
    }
 
    return _braid_error_flag;
@@ -527,11 +659,28 @@ braid_PrintStats(braid_Core  core)
    braid_Int     periodic      = _braid_CoreElt(core, periodic);
    braid_Int     adjoint       = _braid_CoreElt(core, adjoint);
    braid_Optim   optim         = _braid_CoreElt(core, optim);
+   braid_Int     compress      = _braid_CoreElt(core, compress);
+   braid_Real   *comp_gstats   = _braid_CoreElt(core, comp_gstats);
+   braid_Real   *spill_gstats  = _braid_CoreElt(core, spill_gstats);
+   braid_Int     nmembers      = _braid_CoreElt(core, nmembers);
+   braid_Int    *ens_active    = _braid_CoreElt(core, ens_active);
+   braid_Int    *pred_types    = _braid_CoreElt(core, pred_types);
+   braid_Int     pred_default  = _braid_CoreElt(core, pred_default);
+   braid_Real   *step_gstats   = _braid_CoreElt(core, step_gstats);
+   braid_Real   *async_gstats  = _braid_CoreElt(core, async_gstats);
+   braid_Int    *gammas        = _braid_CoreElt(core, gammas);
+   braid_Int     gamma_default = _braid_CoreElt(core, gamma_default);
+   _braid_Tune  *tune          = _braid_CoreElt(core, tune);
+   braid_Real   *tune_gstats   = _braid_CoreElt(core, tune_gstats);
+   braid_Int     mem_nlevels   = _braid_CoreElt(core, mem_nlevels);
+   braid_Real   *mem_gstats    = _braid_CoreElt(core, mem_gstats);
 
    braid_Real    tol_adj;
    braid_Int     rtol_adj;
    braid_Real    rnorm, rnorm_adj;
    braid_Int     level;
+   braid_Int     m, nconverged, ptype, gamma, wcycle, role;
+   braid_Real    nsolve, nsteps, *mem_level;
 
    if (adjoint)
    {
@@ -615,6 +764,39 @@ braid_PrintStats(braid_Core  core)
       _braid_printf("  periodic              = %d\n", periodic);
       _braid_printf("  relax_only_cg         = %d\n", relax_only_cg);
       _braid_printf("  finalFCRelax          = %d\n", finalFCRelax);
+      wcycle = 0;
+      for (level = 1; level < nlevels-1; level++)
+      {
+         gamma = (gammas[level] > 0) ? gammas[level] : gamma_default;
+         if (gamma != 1)
+         {
+            wcycle = 1;
+         }
+      }
+      if (wcycle)
+      {
+         _braid_printf("  cycle gamma by level  =");
+         for (level = 1; level < nlevels-1; level++)
+         {
+            gamma = (gammas[level] > 0) ? gammas[level] : gamma_default;
+            _braid_printf(" %d", gamma);
+         }
+         _braid_printf("\n");
+      }
+      if (_braid_CoreElt(core, accel_depth) > 0)
+      {
+         _braid_printf("  acceleration depth    = %d\n", _braid_CoreElt(core, accel_depth));
+      }
+      if (_braid_CoreElt(core, async_stale) > 0)
+      {
+         _braid_printf("  async max staleness   = %d\n", _braid_CoreElt(core, async_stale));
+         _braid_printf("  stale values used     = %d of %d\n",
+                       (braid_Int) async_gstats[1], (braid_Int) async_gstats[0]);
+      }
+      if (_braid_CoreElt(core, lookahead))
+      {
+         _braid_printf("  lookahead             = on\n");
+      }
       _braid_printf("  number of refinements = %d\n", nrefine);
       _braid_printf("\n");
       _braid_printf("  level   time-pts   cfactor   nrelax   Crelax Wt\n");
@@ -637,6 +819,118 @@ braid_PrintStats(braid_Core  core)
                        level, _braid_GridElt(grids[level], gupper) );
       }
       _braid_printf("\n");
+      if (compress)
+      {
+         _braid_printf("  codec messages        = %d\n", (braid_Int) comp_gstats[0]);
+         _braid_printf("  raw bytes             = %e\n", comp_gstats[1]);
+         _braid_printf("  sent bytes            = %e\n", comp_gstats[2]);
+         if (comp_gstats[2] > 0.0)
+         {
+            _braid_printf("  compression ratio     = %1.2f\n", comp_gstats[1] / comp_gstats[2]);
+         }
+         _braid_printf("\n");
+      }
+      if (_braid_CoreElt(core, spill))
+      {
+         _braid_printf("  resident u-vectors    = %d\n", _braid_CoreElt(core, spill));
+         _braid_printf("  spilled u-vectors     = %d\n", (braid_Int) spill_gstats[0]);
+         _braid_printf("  reloaded u-vectors    = %d\n", (braid_Int) spill_gstats[1]);
+         if (spill_gstats[2] > 0.0)
+         {
+            _braid_printf("  memory per u-vector   = %e bytes\n", spill_gstats[3] / spill_gstats[2]);
+         }
+         _braid_printf("\n");
+      }
+      if ( (tune != NULL) && (tune->ntried > 0) )
+      {
+         m = tune->best;
+         _braid_printf("  auto-tune trials      = %d%s\n", tune->ntried-1,
+                       (tune->phase == 2) ? "" : " (not finished)");
+         _braid_printf("  auto-tuned settings   = cfactor %d, nrelax %d, max_levels %d\n",
+                       tune->configs[3*m], tune->configs[3*m+1], tune->configs[3*m+2]);
+         if ( (tune_gstats != NULL) && (step_gstats != NULL) )
+         {
+            _braid_printf("  level   step cost (s)   recv wait (s)\n");
+            for (level = 0; level < nlevels; level++)
+            {
+               nsteps = step_gstats[3*level+2];
+               nsolve = tune_gstats[3*level+2];
+               _braid_printf("  % 5d     %1.5e     %1.5e\n", level,
+                             (nsteps > 0.0) ? tune_gstats[3*level] / nsteps : 0.0,
+                             (nsolve > 0.0) ? tune_gstats[3*level+1] / nsolve : 0.0);
+            }
+         }
+         _braid_printf("\n");
+      }
+      if ( (step_gstats != NULL) && (niter > 0) && (gupper > 0) )
+      {
+         /* Work per cycle in units of fine-grid sweeps (gupper steps) */
+         nsteps = 0.0;
+         for (level = 0; level < nlevels; level++)
+         {
+            nsteps += step_gstats[3*level+2];
+         }
+         nsteps /= niter;
+         _braid_printf("  work per cycle        = %1.2f fine sweeps (%1.0f steps)\n\n",
+                       nsteps / gupper, nsteps);
+      }
+      nsolve = 0.0;
+      if (step_gstats != NULL)
+      {
+         for (level = 0; level < nlevels; level++)
+         {
+            nsolve += step_gstats[3*level+1];
+         }
+      }
+      if (nsolve > 0.0)
+      {
+         _braid_printf("  level   predictor   solver steps   avg solver iters\n");
+         for (level = 0; level < nlevels; level++)
+         {
+            ptype = (pred_types[level] > -1) ? pred_types[level] : pred_default;
+            nsolve = step_gstats[3*level+1];
+            _braid_printf("  % 5d  % 10d  % 13d   % 16.2f\n", level, ptype, (braid_Int) nsolve,
+                          (nsolve > 0.0) ? step_gstats[3*level] / nsolve : 0.0);
+         }
+         _braid_printf("\n");
+      }
+      if (mem_gstats != NULL)
+      {
+         /* Peak number of vectors of each role, max over processors */
+         mem_level = &mem_gstats[_braid_MemIndex(mem_nlevels, 0)];
+         _braid_printf("  peak vectors per proc = %d (%1.2e bytes)\n",
+                       (braid_Int) mem_level[2], mem_level[3]);
+         _braid_printf("  level       ua       va       fa     temp     tape     comm   peak bytes\n");
+         for (level = 0; level < mem_nlevels; level++)
+         {
+            mem_level = &mem_gstats[_braid_MemIndex(level, 0)];
+            if (mem_level[4*_braid_MEM_NROLES+2] == 0.0)
+            {
+               continue;
+            }
+            _braid_printf("  % 5d", level);
+            for (role = 0; role < _braid_MEM_NROLES; role++)
+            {
+               _braid_printf(" % 8d", (braid_Int) mem_level[4*role+2]);
+            }
+            _braid_printf("   %1.4e\n", mem_level[4*_braid_MEM_NROLES+3]);
+         }
+         _braid_printf("\n");
+      }
+      if (nmembers > 0)
+      {
+         nconverged = 0;
+         for (m = 0; m < nmembers; m++)
+         {
+            if (!ens_active[m])
+            {
+               nconverged++;
+            }
+         }
+         _braid_printf("  ensemble members      = %d\n", nmembers);
+         _braid_printf("  converged members     = %d\n", nconverged);
+         _braid_printf("\n");
+      }
       _braid_printf("  wall time = %f\n", globaltime);
       _braid_printf("\n");
    }
@@ -712,27 +1006,66 @@ braid_SetMaxLevels(braid_Core  core,
    braid_Int             *nrels          = _braid_CoreElt(core, nrels);
    braid_Real            *CWts           = _braid_CoreElt(core, CWts);
    braid_Int             *cfactors       = _braid_CoreElt(core, cfactors);
+   braid_Int             *comp_sizes     = _braid_CoreElt(core, comp_sizes);
+   braid_Int             *pred_types     = _braid_CoreElt(core, pred_types);
+   braid_Int             *gammas         = _braid_CoreElt(core, gammas);
+   braid_Real            *step_stats     = _braid_CoreElt(core, step_stats);
+   braid_Real            *tune_stats     = _braid_CoreElt(core, tune_stats);
+   braid_Int              mem_nlevels    = _braid_CoreElt(core, mem_nlevels);
+   braid_Real            *mem_stats      = _braid_CoreElt(core, mem_stats);
    _braid_Grid          **grids          = _braid_CoreElt(core, grids);
-   braid_Int              level;
+   braid_Int              level, i;
 
    _braid_CoreElt(core, max_levels) = max_levels;
 
    nrels = _braid_TReAlloc(nrels, braid_Int, max_levels);
    CWts = _braid_TReAlloc(CWts, braid_Real, max_levels);
    cfactors = _braid_TReAlloc(cfactors, braid_Int, max_levels);
+   comp_sizes = _braid_TReAlloc(comp_sizes, braid_Int, max_levels);
+   pred_types = _braid_TReAlloc(pred_types, braid_Int, max_levels);
+   gammas = _braid_TReAlloc(gammas, braid_Int, max_levels);
+   step_stats = _braid_TReAlloc(step_stats, braid_Real, 3*max_levels);
+   tune_stats = _braid_TReAlloc(tune_stats, braid_Real, 3*max_levels);
    grids    = _braid_TReAlloc(grids, _braid_Grid *, max_levels);
    for (level = old_max_levels; level < max_levels; level++)
    {
       nrels[level]    = -1;
       CWts[level]    = -1.0;
       cfactors[level] = 0;
+      comp_sizes[level] = -2;
+      pred_types[level] = -1;
+      gammas[level] = 0;
+      step_stats[3*level]   = 0.0;
+      step_stats[3*level+1] = 0.0;
+      step_stats[3*level+2] = 0.0;
+      tune_stats[3*level]   = 0.0;
+      tune_stats[3*level+1] = 0.0;
+      tune_stats[3*level+2] = 0.0;
       grids[level]    = NULL;
    }
    _braid_CoreElt(core, nrels)    = nrels;
    _braid_CoreElt(core, CWts)     = CWts;
    _braid_CoreElt(core, cfactors) = cfactors;
+   _braid_CoreElt(core, comp_sizes) = comp_sizes;
+   _braid_CoreElt(core, pred_types) = pred_types;
+   _braid_CoreElt(core, gammas) = gammas;
+   _braid_CoreElt(core, step_stats) = step_stats;
+   _braid_CoreElt(core, tune_stats) = tune_stats;
    _braid_CoreElt(core, grids)    = grids;
 
+   /* The memory statistics are never shrunk, since vectors counted on the
+    * dropped levels may still be live */
+   if (max_levels > mem_nlevels)
+   {
+      mem_stats = _braid_TReAlloc(mem_stats, braid_Real, _braid_MemIndex(max_levels, 0));
+      for (i = _braid_MemIndex(mem_nlevels, 0); i < _braid_MemIndex(max_levels, 0); i++)
+      {
+         mem_stats[i] = 0.0;
+      }
+      _braid_CoreElt(core, mem_nlevels) = max_levels;
+      _braid_CoreElt(core, mem_stats)   = mem_stats;
+   }
+
    return _braid_error_flag;
 }
 
@@ -1092,6 +1425,36 @@ braid_SetNFMGVcyc(braid_Core  core,
    return _braid_error_flag;
 }
 
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetCycleGamma(braid_Core  core,
+                    braid_Int   level,
+                    braid_Int   gamma)
+{
+   braid_Int  *gammas = _braid_CoreElt(core, gammas);
+
+   if (gamma < 1)
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Cycle gamma must be at least 1\n");
+      return _braid_error_flag;
+   }
+
+   if (level < 0)
+   {
+      /* Set default value */
+      _braid_CoreElt(core, gamma_default) = gamma;
+   }
+   else if (level < _braid_CoreElt(core, max_levels))
+   {
+      /* Set gamma on specified level */
+      gammas[level] = gamma;
+   }
+
+   return _braid_error_flag;
+}
+
 /*--------------------------------------------------------------------------
  *--------------------------------------------------------------------------*/
 
@@ -1254,6 +1617,31 @@ braid_GetNumIter(braid_Core   core,
    return _braid_error_flag;
 }
 
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_GetEnsembleStats(braid_Core   core,
+                       braid_Int    member,
+                       braid_Int   *niter_ptr,
+                       braid_Real  *rnorm_ptr)
+{
+   if ( (member < 0) || (member >= _braid_CoreElt(core, nmembers)) )
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Invalid ensemble member\n");
+      return _braid_error_flag;
+   }
+
+   *niter_ptr = _braid_CoreElt(core, ens_niter)[member];
+   if (*niter_ptr < 0)
+   {
+      *niter_ptr = _braid_CoreElt(core, niter);
+   }
+   *rnorm_ptr = _braid_CoreElt(core, ens_rnorm)[member];
+
+   return _braid_error_flag;
+}
+
 /*--------------------------------------------------------------------------
  *--------------------------------------------------------------------------*/
 
@@ -1647,3 +2035,400 @@ braid_SetRichardsonEstimation(braid_Core core,
    return _braid_error_flag;
 }
 
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetCompression(braid_Core  core,
+                     braid_Int   level,
+                     braid_Int   min_size)
+{
+   braid_Int  *comp_sizes = _braid_CoreElt(core, comp_sizes);
+
+   if (min_size < 0)
+   {
+      min_size = -1;
+   }
+   else
+   {
+      _braid_CoreElt(core, compress) = 1;
+   }
+
+   if (level < 0)
+   {
+      /* Set default value */
+      _braid_CoreElt(core, comp_size_default) = min_size;
+   }
+   else
+   {
+      /* Set minimum size on specified level */
+      comp_sizes[level] = min_size;
+   }
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetCodec(braid_Core             core,
+               braid_PtFcnCompress    compress,
+               braid_PtFcnDecompress  decompress)
+{
+   _braid_CoreElt(core, compressfcn)   = compress;
+   _braid_CoreElt(core, decompressfcn) = decompress;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_GetCompressionStats(braid_Core   core,
+                          braid_Int   *nmsgs_ptr,
+                          braid_Real  *raw_bytes_ptr,
+                          braid_Real  *sent_bytes_ptr)
+{
+   braid_Real  *comp_gstats = _braid_CoreElt(core, comp_gstats);
+
+   *nmsgs_ptr      = (braid_Int) comp_gstats[0];
+   *raw_bytes_ptr  = comp_gstats[1];
+   *sent_bytes_ptr = comp_gstats[2];
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetSharedMemory(braid_Core  core,
+                      braid_Int   shmem)
+{
+   _braid_CoreElt(core, shmem) = shmem;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetOutOfCore(braid_Core   core,
+                   braid_Int    nresident,
+                   const char  *dir)
+{
+   if (_braid_CoreElt(core, spill_dir) != NULL)
+   {
+      _braid_TFree(_braid_CoreElt(core, spill_dir));
+   }
+   if (dir != NULL)
+   {
+      _braid_CoreElt(core, spill_dir) = _braid_CTAlloc(char, strlen(dir)+1);
+      strcpy(_braid_CoreElt(core, spill_dir), dir);
+   }
+   _braid_CoreElt(core, spill)          = (nresident > 0) ? nresident : 0;
+   _braid_CoreElt(core, spill_compress) = 0;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetCompressedStorage(braid_Core  core,
+                           braid_Int   nresident)
+{
+   _braid_CoreElt(core, spill)          = (nresident > 0) ? nresident : 0;
+   _braid_CoreElt(core, spill_compress) = 1;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetCheckpoint(braid_Core   core,
+                    braid_Int    interval,
+                    const char  *filename)
+{
+   if (_braid_CoreElt(core, ckpt_file) != NULL)
+   {
+      _braid_TFree(_braid_CoreElt(core, ckpt_file));
+   }
+   if ( (interval > 0) && (filename != NULL) )
+   {
+      _braid_CoreElt(core, ckpt_file) = _braid_CTAlloc(char, strlen(filename)+1);
+      strcpy(_braid_CoreElt(core, ckpt_file), filename);
+      _braid_CoreElt(core, ckpt_interval) = interval;
+   }
+   else
+   {
+      _braid_CoreElt(core, ckpt_interval) = 0;
+   }
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetEnsemble(braid_Core               core,
+                  braid_Int                nmembers,
+                  braid_PtFcnEnsembleNorm  enorm)
+{
+   braid_Int  m;
+
+   if ( (nmembers > 0) && (enorm == NULL) )
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Ensemble mode requires an ensemble norm function\n");
+      return _braid_error_flag;
+   }
+   if ( (nmembers > 0) && _braid_CoreElt(core, adjoint) )
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Ensemble mode is not supported with the adjoint\n");
+      return _braid_error_flag;
+   }
+
+   _braid_TFree(_braid_CoreElt(core, ens_active));
+   _braid_TFree(_braid_CoreElt(core, ens_niter));
+   _braid_TFree(_braid_CoreElt(core, ens_rnorm));
+   _braid_TFree(_braid_CoreElt(core, ens_rnorm0));
+   _braid_TFree(_braid_CoreElt(core, ens_lnorm));
+   _braid_TFree(_braid_CoreElt(core, ens_snorm));
+
+   if (nmembers < 0)
+   {
+      nmembers = 0;
+   }
+   _braid_CoreElt(core, nmembers)      = nmembers;
+   _braid_CoreElt(core, ensemble_norm) = enorm;
+
+   if (nmembers > 0)
+   {
+      _braid_CoreElt(core, ens_active) = _braid_CTAlloc(braid_Int,  nmembers);
+      _braid_CoreElt(core, ens_niter)  = _braid_CTAlloc(braid_Int,  nmembers);
+      _braid_CoreElt(core, ens_rnorm)  = _braid_CTAlloc(braid_Real, nmembers);
+      _braid_CoreElt(core, ens_rnorm0) = _braid_CTAlloc(braid_Real, nmembers);
+      _braid_CoreElt(core, ens_lnorm)  = _braid_CTAlloc(braid_Real, nmembers);
+      _braid_CoreElt(core, ens_snorm)  = _braid_CTAlloc(braid_Real, nmembers);
+      for (m = 0; m < nmembers; m++)
+      {
+         _braid_CoreElt(core, ens_active)[m] = 1;
+         _braid_CoreElt(core, ens_niter)[m]  = -1;
+         _braid_CoreElt(core, ens_rnorm)[m]  = braid_INVALID_RNORM;
+         _braid_CoreElt(core, ens_rnorm0)[m] = braid_INVALID_RNORM;
+      }
+   }
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetAcceleration(braid_Core  core,
+                      braid_Int   depth)
+{
+   _braid_AccelDestroy(core);
+   _braid_CoreElt(core, accel_depth) = (depth > 0) ? depth : 0;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetPredictor(braid_Core  core,
+                   braid_Int   level,
+                   braid_Int   ptype)
+{
+   braid_Int  *pred_types = _braid_CoreElt(core, pred_types);
+
+   if ( (ptype < braid_PRED_NONE) || (ptype > braid_PRED_CORRECTION) )
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Unknown predictor type\n");
+      return _braid_error_flag;
+   }
+
+   if (level < 0)
+   {
+      /* Set default value */
+      _braid_CoreElt(core, pred_default) = ptype;
+   }
+   else if (level < _braid_CoreElt(core, max_levels))
+   {
+      /* Set predictor on specified level */
+      pred_types[level] = ptype;
+   }
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_GetSolverIters(braid_Core   core,
+                     braid_Int    level,
+                     braid_Int   *nsteps_ptr,
+                     braid_Real  *avg_iters_ptr)
+{
+   braid_Real  *step_gstats = _braid_CoreElt(core, step_gstats);
+   braid_Real   nsteps = 0.0, niters = 0.0;
+
+   if ( (step_gstats != NULL) && (level >= 0) && (level < _braid_CoreElt(core, max_levels)) )
+   {
+      niters = step_gstats[3*level];
+      nsteps = step_gstats[3*level+1];
+   }
+   *nsteps_ptr    = (braid_Int) nsteps;
+   *avg_iters_ptr = (nsteps > 0.0) ? niters / nsteps : 0.0;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetVectorSize(braid_Core             core,
+                    braid_PtFcnVectorSize  vsize)
+{
+   _braid_CoreElt(core, vsize) = vsize;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_GetMemoryStats(braid_Core   core,
+                     braid_Int    level,
+                     braid_Int    role,
+                     braid_Int   *nvectors_ptr,
+                     braid_Real  *bytes_ptr,
+                     braid_Int   *peak_nvectors_ptr,
+                     braid_Real  *peak_bytes_ptr)
+{
+   braid_Int    mem_nlevels = _braid_CoreElt(core, mem_nlevels);
+   braid_Real  *mem_stats   = _braid_CoreElt(core, mem_stats);
+   braid_Real   stats[4], *s;
+   braid_Int    lo, hi, l, k;
+
+   for (k = 0; k < 4; k++)
+   {
+      stats[k] = 0.0;
+   }
+
+   if ( (level == -1) && (role == -1) )
+   {
+      /* The overall total has its own peaks */
+      for (k = 0; k < 4; k++)
+      {
+         stats[k] = _braid_CoreElt(core, mem_total)[k];
+      }
+   }
+   else if ( (mem_stats != NULL) && (level >= -1) && (level < mem_nlevels) &&
+             (role >= -1) && (role < _braid_MEM_NROLES) )
+   {
+      lo = (level == -1) ? 0 : level;
+      hi = (level == -1) ? mem_nlevels-1 : level;
+      for (l = lo; l <= hi; l++)
+      {
+         s = &mem_stats[_braid_MemIndex(l, (role == -1) ? _braid_MEM_NROLES : role)];
+         for (k = 0; k < 4; k++)
+         {
+            stats[k] += s[k];
+         }
+      }
+   }
+
+   *nvectors_ptr      = (braid_Int) stats[0];
+   *bytes_ptr         = stats[1];
+   *peak_nvectors_ptr = (braid_Int) stats[2];
+   *peak_bytes_ptr    = stats[3];
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetAsyncRelax(braid_Core  core,
+                    braid_Int   max_stale)
+{
+   _braid_CoreElt(core, async_stale) = _braid_max(max_stale, 0);
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetLookahead(braid_Core  core,
+                   braid_Int   lookahead)
+{
+   _braid_CoreElt(core, lookahead) = lookahead;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetTrace(braid_Core   core,
+               braid_Int    max_events,
+               const char  *filename)
+{
+   _braid_Trace  *trace = _braid_CoreElt(core, trace);
+
+   /* Discard any previous tracer state */
+   if (trace != NULL)
+   {
+      _braid_TFree(trace->events);
+      _braid_TFree(trace->filename);
+      _braid_TFree(trace);
+   }
+
+   trace = NULL;
+   if (max_events > 0)
+   {
+      if (filename == NULL)
+      {
+         filename = "braid.trace.json";
+      }
+      trace = _braid_CTAlloc(_braid_Trace, 1);
+      trace->size     = max_events;
+      trace->events   = NULL;
+      trace->filename = _braid_CTAlloc(char, strlen(filename)+1);
+      strcpy(trace->filename, filename);
+   }
+   _braid_CoreElt(core, trace) = trace;
+
+   return _braid_error_flag;
+}
+
+/*--------------------------------------------------------------------------
+ *--------------------------------------------------------------------------*/
+
+braid_Int
+braid_SetAutoTune(braid_Core  core,
+                  braid_Int   max_trials)
+{
+   _braid_TuneDestroy(core);
+   _braid_CoreElt(core, tune_max) = _braid_max(max_trials, 0);
+
+   return _braid_error_flag;
+}
@@ -86,6 +86,49 @@ extern "C" {
 /* bits 4-8 are reserved for the index of the argument error */
 /** @} */
 
+/*--------------------------------------------------------------------------
+ * Predictor types
+ *--------------------------------------------------------------------------*/
+/** \defgroup predictors Predictor types
+ *
+ * Initial guesses (ustop) for implicit steps, see @ref braid_SetPredictor
+ * @{
+ */
+
+/** Default guess: the stored value at tstop, if available, otherwise u */
+#define braid_PRED_NONE        0
+/** Linear extrapolation in time from the last two time points */
+#define braid_PRED_LINEAR      1
+/** Quadratic extrapolation in time from the last three time points */
+#define braid_PRED_QUADRATIC   2
+/** Guess from the previous iteration at tstop, plus the current correction at tstart */
+#define braid_PRED_CORRECTION  3
+/** @} */
+
+/*--------------------------------------------------------------------------
+ * Vector roles
+ *--------------------------------------------------------------------------*/
+/** \defgroup memroles Vector roles
+ *
+ * Roles of the vectors counted in the memory statistics, see
+ * @ref braid_GetMemoryStats
+ * @{
+ */
+
+/** Stored solution values (u-vectors, see @ref braid_SetStorage) */
+#define braid_MEM_UA    0
+/** Restricted solution values on coarse levels */
+#define braid_MEM_VA    1
+/** FAS right-hand sides on coarse levels */
+#define braid_MEM_FA    2
+/** Temporary vectors, e.g., during relaxation, and predictor and acceleration history */
+#define braid_MEM_TEMP  3
+/** Copies recorded on the tape for the adjoint */
+#define braid_MEM_TAPE  4
+/** Received boundary values and message buffers */
+#define braid_MEM_COMM  5
+/** @} */
+
 /*--------------------------------------------------------------------------
  * User-written routines
  *--------------------------------------------------------------------------*/
@@ -190,6 +233,33 @@ typedef braid_Int
                           braid_Real    *norm_ptr  /**< output, norm of braid_Vector (this is a spatial norm) */ 
                           );
 
+/**
+ * (optional) In ensemble mode (see [braid_SetEnsemble](@ref braid_SetEnsemble)),
+ * each braid_Vector holds all ensemble members, and this function computes the
+ * spatial norm of each member separately, 
+ * *norms[m]* = || member *m* of *u* ||,  for m = 0, ..., nmembers-1. 
+ * These norms are combined over time (see
+ * [braid_SetTemporalNorm](@ref braid_SetTemporalNorm)) into one residual norm
+ * per member, which controls halting for that member.
+ **/
+typedef braid_Int
+(*braid_PtFcnEnsembleNorm)(braid_App      app,      /**< user-defined _braid_App structure */
+                           braid_Vector   u,        /**< vector holding all ensemble members */
+                           braid_Real    *norms     /**< output, spatial norm of each ensemble member */
+                           );
+
+/**
+ * (optional) Returns the size of vector *u* in bytes, for the memory
+ * statistics (see [braid_SetVectorSize](@ref braid_SetVectorSize)).  It is
+ * called when a vector is created, and for shell vectors also after their data
+ * was freed, so it should be cheap.
+ **/
+typedef braid_Int
+(*braid_PtFcnVectorSize)(braid_App      app,      /**< user-defined _braid_App structure */
+                         braid_Vector   u,        /**< vector to measure (may be a shell) */
+                         braid_Real    *size_ptr  /**< output, size of *u* in bytes */
+                         );
+
 /**
  * Gives user access to XBraid and to the current vector *u* at time *t*.  Most
  * commonly, this lets the user write the vector to screen, file, etc...  The
@@ -350,6 +420,34 @@ typedef braid_Int
                        braid_Int        *iupper     /**< upper time index value for this processor */
                        );
 
+/**
+ * (Optional) Compress the packed buffer *inbuf* of *insize* bytes into
+ * *outbuf*.  On input, *outsize_ptr* holds the number of bytes available in
+ * *outbuf*.  On output, it holds the compressed size, or a negative value if
+ * the data does not fit, in which case XBraid sends the uncompressed buffer.
+ * See [braid_SetCodec](@ref braid_SetCodec).
+ **/
+typedef braid_Int
+(*braid_PtFcnCompress)(braid_App      app,          /**< user-defined _braid_App structure */
+                       void          *inbuf,        /**< packed buffer from BufPack */
+                       braid_Int      insize,       /**< size of the packed buffer in bytes */
+                       void          *outbuf,       /**< output, compressed buffer */
+                       braid_Int     *outsize_ptr   /**< input: capacity of *outbuf*, output: compressed size in bytes (negative if not compressed) */
+                       );
+
+/**
+ * (Optional) Decompress *inbuf* of *insize* bytes, produced by the user's
+ * compress routine, into *outbuf*.  The decompressed size *outsize* is the
+ * size of the original packed buffer.
+ **/
+typedef braid_Int
+(*braid_PtFcnDecompress)(braid_App      app,        /**< user-defined _braid_App structure */
+                         void          *inbuf,      /**< compressed buffer */
+                         braid_Int      insize,     /**< size of the compressed buffer in bytes */
+                         void          *outbuf,     /**< output, packed buffer to be passed to BufUnpack */
+                         braid_Int      outsize     /**< size of the packed buffer in bytes */
+                         );
+
 /** @}*/
 
 /*--------------------------------------------------------------------------
@@ -696,6 +794,24 @@ braid_SetNFMGVcyc(braid_Core  core,         /**< braid_Core (_braid_Core) struct
                   braid_Int   nfmg_Vcyc     /**< number of V-cycles to do each FMG level */
                   );
 
+/**
+ * Set the cycle shape through the number of coarse-grid corrections *gamma*
+ * computed on each visit to *level*, i.e., the number of visits to level+1.
+ * The default gamma = 1 gives V-cycles, gamma = 2 on all levels gives
+ * W-cycles, and a larger gamma on a few levels adds extra coarse visits where
+ * they pay off (e.g., for hyperbolic problems with cheap coarse levels).  On
+ * the finest level, gamma > 1 is the same as more iterations and is ignored,
+ * as is gamma on the coarsest level, which is solved directly.  With FMG, the
+ * FMG cycles are built from these cycles.  Setting *level* = -1 sets the
+ * default for all levels.  @ref braid_PrintStats reports the resulting work
+ * per cycle.
+ **/
+braid_Int
+braid_SetCycleGamma(braid_Core  core,        /**< braid_Core (_braid_Core) struct*/
+                    braid_Int   level,       /**< level to set gamma on, -1 for all levels */
+                    braid_Int   gamma        /**< number of visits to level+1 per visit to level (1: V-cycle, 2: W-cycle) */
+                    );
+
 
 /**
  * Sets the storage properties of the code.
@@ -909,6 +1025,439 @@ braid_SetShell(braid_Core          core,
                braid_PtFcnSFree    sfree
                );
 
+/**
+ * Turn on compression of vector messages.  Packed buffers from BufPack that
+ * are at least *min_size* bytes are compressed before they are sent, and
+ * decompressed before BufUnpack is called.  If compression does not reduce the
+ * size of a buffer, it is sent uncompressed.  A negative *min_size* turns
+ * compression off.  If *level* is -1, *min_size* is the default for all
+ * levels, otherwise it only applies to *level*.
+ *
+ * By default, a built-in lossless codec (byte-shuffle of the braid_Real values
+ * followed by LZ compression) is used; see
+ * [braid_SetCodec](@ref braid_SetCodec) for using your own.  Messages for
+ * load balancing after temporal refinement go through the level 0 codec.  The
+ * number of compressed messages and the raw and sent byte counts are shown by
+ * [braid_PrintStats](@ref braid_PrintStats).
+ *
+ * Default is no compression.
+ **/
+braid_Int
+braid_SetCompression(braid_Core  core,        /**< braid_Core (_braid_Core) struct*/
+                     braid_Int   level,       /**< level to set min_size for, or -1 for all levels */
+                     braid_Int   min_size     /**< minimum message size in bytes to compress, negative is off */
+                     );
+
+/**
+ * Replace the built-in codec used by
+ * [braid_SetCompression](@ref braid_SetCompression) with the user routines
+ * *compress* and *decompress*.
+ **/
+braid_Int
+braid_SetCodec(braid_Core             core,         /**< braid_Core (_braid_Core) struct*/
+               braid_PtFcnCompress    compress,     /**< user compression routine */
+               braid_PtFcnDecompress  decompress    /**< user decompression routine */
+               );
+
+/**
+ * After Drive() finishes, this returns the number of messages that passed
+ * through the codec layer and their total size in bytes before (*raw*) and
+ * after (*sent*) compression, summed over all processors.
+ **/
+braid_Int
+braid_GetCompressionStats(braid_Core   core,             /**< braid_Core (_braid_Core) struct*/
+                          braid_Int   *nmsgs_ptr,        /**< output, number of messages */
+                          braid_Real  *raw_bytes_ptr,    /**< output, bytes packed by BufPack */
+                          braid_Real  *sent_bytes_ptr    /**< output, bytes sent, including codec headers */
+                          );
+
+/**
+ * Pass vectors between time neighbors that share a node through an MPI-3
+ * shared-memory window instead of MPI messages.  The sender packs directly
+ * into a message slot owned by the receiver and raises a flag, and the
+ * receiver unpacks from the slot and clears the flag.  Each processor holds
+ * one slot per level, sized by BufSize.  Neighbors on other nodes still use
+ * MPI (and [braid_SetCompression](@ref braid_SetCompression), if set).
+ * Must be called before [braid_Drive](@ref braid_Drive).  Has no effect in
+ * the sequential build or without MPI-3.
+ *
+ * Default is 0 (off).
+ **/
+braid_Int
+braid_SetSharedMemory(braid_Core  core,       /**< braid_Core (_braid_Core) struct*/
+                      braid_Int   shmem       /**< Boolean, 1: use shared memory for on-node neighbors, 0: always use MPI */
+                      );
+
+/**
+ * Keep at most *nresident* u-vectors of the fine grid in memory on each
+ * processor.  Colder u-vectors are packed with BufPack into a memory-mapped
+ * scratch file in directory *dir* (one per processor, removed automatically)
+ * and unpacked again when they are next needed.  The u-vectors next to one
+ * that is read back are prefetched.  This trades local disk bandwidth for
+ * memory, e.g., with [braid_SetStorage](@ref braid_SetStorage)(core, 0) on
+ * long time horizons.  If *dir* is NULL, $TMPDIR (or the current directory)
+ * is used.  The u-vector sent to the right neighbor is never spilled.  Must
+ * be called before [braid_Drive](@ref braid_Drive).
+ *
+ * Default is 0 (all u-vectors in memory).
+ **/
+braid_Int
+braid_SetOutOfCore(braid_Core   core,       /**< braid_Core (_braid_Core) struct*/
+                   braid_Int    nresident,  /**< max number of resident fine-grid u-vectors per processor, 0 turns this off */
+                   const char  *dir         /**< scratch directory for the spill files, or NULL */
+                   );
+
+/**
+ * Keep at most *nresident* u-vectors of the fine grid uncompressed in memory
+ * on each processor.  Colder u-vectors are packed with BufPack, compressed
+ * (with the built-in codec, or the one set with
+ * [braid_SetCodec](@ref braid_SetCodec)), and kept in memory until they are
+ * next needed.  The u-vectors in use and the one sent to the right neighbor
+ * stay uncompressed.  PrintStats reports the average memory per u-vector.
+ * This replaces [braid_SetOutOfCore](@ref braid_SetOutOfCore), and vice
+ * versa.  Must be called before [braid_Drive](@ref braid_Drive).
+ *
+ * Default is 0 (all u-vectors uncompressed).
+ **/
+braid_Int
+braid_SetCompressedStorage(braid_Core  core,       /**< braid_Core (_braid_Core) struct*/
+                           braid_Int   nresident   /**< max number of uncompressed fine-grid u-vectors per processor, 0 turns this off */
+                           );
+
+/**
+ * Write the state of the solve to *filename* (collective): the fine-grid
+ * u-vectors (packed with BufPack), the time values, the refinement factors,
+ * the residual norm history and the iteration count.  All processors in time
+ * write one file with MPI-IO.  With spatial parallelism, each spatial rank
+ * writes its own file, with its rank appended to *filename*.  Call after
+ * [braid_Drive](@ref braid_Drive), or see
+ * [braid_SetCheckpoint](@ref braid_SetCheckpoint) to write checkpoints while
+ * iterating.
+ **/
+braid_Int
+braid_WriteCheckpoint(braid_Core   core,       /**< braid_Core (_braid_Core) struct*/
+                      const char  *filename    /**< checkpoint file name */
+                      );
+
+/**
+ * Read a checkpoint written by [braid_WriteCheckpoint](@ref braid_WriteCheckpoint)
+ * (collective).  Call after braid_Init() and all other braid_Set routines, but
+ * instead of the first call to [braid_Drive](@ref braid_Drive).  The next
+ * braid_Drive() then continues iterating from the checkpoint (as a warm
+ * restart), counting toward the same max_iter.  The checkpoint may be read
+ * with a different number of processors in time, but the spatial
+ * decomposition and BufSize must be the same.  Adjoint runs are not supported.
+ **/
+braid_Int
+braid_ReadCheckpoint(braid_Core   core,       /**< braid_Core (_braid_Core) struct*/
+                     const char  *filename    /**< checkpoint file name */
+                     );
+
+/**
+ * Write a checkpoint to *filename* every *interval* MGRIT iterations inside
+ * [braid_Drive](@ref braid_Drive), overwriting the previous one.
+ *
+ * Default is 0 (no checkpoints).
+ **/
+braid_Int
+braid_SetCheckpoint(braid_Core   core,       /**< braid_Core (_braid_Core) struct*/
+                    braid_Int    interval,   /**< number of iterations between checkpoints, 0 turns this off */
+                    const char  *filename    /**< checkpoint file name */
+                    );
+
+/**
+ * Turn on ensemble mode: one XBraid core solves *nmembers* independent problems
+ * (e.g., the same model with different initial conditions or coefficients).
+ * Each braid_Vector holds the state of all members, so every user callback
+ * (Step, Sum, BufPack, ...) works on the whole batch, each boundary message
+ * carries all members, and the residual norms of all members are combined in
+ * one MPI_Allreduce per iteration.  The function *enorm* returns the spatial
+ * norm of each member, and convergence is checked per member with the usual
+ * halting tolerance (relative to each member's own initial residual with
+ * rtol).  A converged member drops out: it no longer counts toward the
+ * residual norm or the halting test, and XBraid halts when all members have
+ * converged.  Step() must still propagate converged members (MGRIT keeps
+ * overwriting their F-points), but may treat them more cheaply, e.g., with a
+ * looser spatial solver tolerance, see
+ * [braid_StepStatusGetEnsembleActive](@ref braid_StepStatusGetEnsembleActive).  Not supported with the
+ * adjoint or the full residual norm.
+ *
+ * Default is 0 (no ensemble).
+ **/
+braid_Int
+braid_SetEnsemble(braid_Core               core,       /**< braid_Core (_braid_Core) struct*/
+                  braid_Int                nmembers,   /**< number of ensemble members held by each braid_Vector */
+                  braid_PtFcnEnsembleNorm  enorm       /**< computes the spatial norm of each member */
+                  );
+
+/**
+ * After Drive() finishes, this returns the number of iterations taken by
+ * ensemble member *member* and its residual norm at that iteration.  Members that did not
+ * converge return the total number of iterations.
+ **/
+braid_Int
+braid_GetEnsembleStats(braid_Core   core,         /**< braid_Core (_braid_Core) struct*/
+                       braid_Int    member,       /**< ensemble member, 0 <= member < nmembers */
+                       braid_Int   *niter_ptr,    /**< output, number of iterations until the member converged */
+                       braid_Real  *rnorm_ptr     /**< output, last residual norm of the member */
+                       );
+
+/**
+ * Accelerate the MGRIT iterations with Anderson acceleration of depth *depth*.
+ * One MGRIT cycle is used as a preconditioner (fixed-point map) on the
+ * fine-grid C-point values, and the next iterate is extrapolated from the last
+ * *depth* cycles.  For linear problems, this is equivalent to GMRES
+ * preconditioned by MGRIT, and it also applies to nonlinear problems.  Only
+ * the Sum and SpatialNorm routines are used: inner products are computed from
+ * norms with the polarization identity, so SpatialNorm must be induced by an
+ * inner product (e.g., the standard Euclidean norm).  The history is dropped
+ * whenever the residual norm grows.  Each processor stores about 2*depth+3
+ * vectors per fine-grid C-point.  Not used for adjoint runs.
+ *
+ * Default is 0 (no acceleration).
+ **/
+braid_Int
+braid_SetAcceleration(braid_Core  core,        /**< braid_Core (_braid_Core) struct*/
+                      braid_Int   depth        /**< number of previous cycles used, 0 turns this off */
+                      );
+
+/**
+ * Turn on experimental asynchronous (stale-tolerant) relaxation.  Normally, each
+ * processor waits in the left-most interval of a relaxation sweep until the
+ * newest C-point value from its left neighbor arrives.  In asynchronous mode,
+ * if that value has not arrived yet, the sweep continues from the newest value
+ * received earlier, and the message is consumed by a later sweep once it
+ * lands.  At most *max_stale* consecutive sweeps on a level use a stale value
+ * before the processor waits again.  This trades some extra iterations for
+ * less idle time when load imbalance or system noise makes the lock-step
+ * relaxation wait-dominated.  The iterates then depend on message timing, so
+ * runs are not reproducible.  Residual norms and the final relaxation are
+ * computed as usual, and the coarsest level is still solved sequentially.
+ * Only messages sent through MPI are tested; values passed through shared
+ * memory (see @ref braid_SetSharedMemory) are still waited for.  The number of
+ * stale values used is reported by @ref braid_PrintStats.  Not used for
+ * adjoint runs or with Richardson extrapolation.
+ *
+ * Default is 0 (lock-step relaxation).
+ **/
+braid_Int
+braid_SetAsyncRelax(braid_Core  core,          /**< braid_Core (_braid_Core) struct*/
+                    braid_Int   max_stale      /**< max consecutive sweeps using a stale value, 0 turns this off */
+                    );
+
+/**
+ * Turn on lookahead across MGRIT iterations.  Normally, the global residual
+ * norm is reduced over all processors right after the fine-grid restriction,
+ * so every iteration starts with a global synchronization.  With lookahead,
+ * this reduction is non-blocking: each processor continues with the coarse
+ * grids, and the norm is only completed when it is needed, at the latest for
+ * the convergence check at the end of the cycle, by which time all processors
+ * have contributed.  Processors that finish their part of the cycle early (at
+ * the left end of time) can then start the next iteration's fine-grid
+ * relaxation right away, and nothing needs to be discarded on convergence
+ * since the decision is based on the same norm as without lookahead.  The
+ * iterates and residual norms are unchanged.  Making the norm available to
+ * the user on coarse levels (access level 3) or writing the cycle output file
+ * on processor 0 (see @ref braid_SetFileIOLevel) completes the reduction
+ * early, so these should be turned off for the best overlap.  Requires MPI-3 (otherwise the reduction stays blocking), and is not used in
+ * ensemble mode.
+ *
+ * Default is 0 (blocking reduction).
+ **/
+braid_Int
+braid_SetLookahead(braid_Core  core,           /**< braid_Core (_braid_Core) struct*/
+                   braid_Int   lookahead       /**< boolean, 1 turns lookahead on */
+                   );
+
+/**
+ * Turn on the event timeline.  Each processor records the start and duration
+ * of every step, message send and wait, buffer pack and unpack, spatial
+ * coarsening and refinement, and of the cycle phases (FCRelax, FRestrict,
+ * FInterp and the work at the top of each cycle), with its level, time index
+ * and iteration.  The newest *max_events* events are kept in a ring buffer on
+ * each processor (about 40 bytes per event).  At @ref braid_Destroy, the
+ * events of all processors are written to *filename* (collective) in the
+ * Chrome trace format, which can be opened with chrome://tracing or
+ * ui.perfetto.dev to see where processors wait in the pipeline.  The clocks of
+ * the processors are aligned at a barrier at the start of the first
+ * @ref braid_Drive.  Must be called before @ref braid_Drive.
+ *
+ * Default is 0 (no tracing).  If *filename* is NULL, braid.trace.json is used.
+ **/
+braid_Int
+braid_SetTrace(braid_Core   core,              /**< braid_Core (_braid_Core) struct*/
+               braid_Int    max_events,        /**< max number of events kept per processor, 0 turns this off */
+               const char  *filename           /**< name of the trace file */
+               );
+
+/**
+ * Turn on online auto-tuning of the coarsening factor, the number of
+ * CF-relaxations (0 is F-relaxation) and the number of levels.  Starting from
+ * the current settings, each trial configuration is run for two MGRIT
+ * iterations, and the wall time and convergence factor of the second one give
+ * the predicted time to reach the tolerance.  The tuner moves to the best
+ * neighboring configuration (coarsening factor doubled or halved, one
+ * relaxation or level more or less) until none is better or *max_trials*
+ * configurations have been tried, and then keeps the best one.  The trial
+ * configurations use the same settings on all levels, and the hierarchy is
+ * rebuilt between cycles on the same fine grid, so the trial iterations also
+ * reduce the residual.  The chosen settings are printed (print level 1 or
+ * higher) and shown by @ref braid_PrintStats, together with the measured step
+ * cost and receive wait time on each level, so they can be set directly for
+ * production runs.  Not used with refinement, Richardson extrapolation, shell
+ * vectors, periodic problems or adjoint runs.
+ *
+ * Default is 0 (no tuning).
+ **/
+braid_Int
+braid_SetAutoTune(braid_Core  core,            /**< braid_Core (_braid_Core) struct*/
+                  braid_Int   max_trials       /**< max number of trial configurations, 0 turns this off */
+                  );
+
+/**
+ * Set the predictor used to build the initial guess *ustop* that is passed to
+ * the Step routine on *level* (see @ref predictors).  Implicit (e.g., Newton)
+ * solvers converge in fewer iterations from a better guess.
+ *
+ * - *braid_PRED_LINEAR* and *braid_PRED_QUADRATIC* extrapolate in time from
+ *   the input u and the inputs of the last one or two steps, when these were
+ *   taken at the preceding time points.
+ * - *braid_PRED_CORRECTION* adds the change of u at tstart since the last
+ *   guess at tstart to the default guess at tstop.  This needs a stored guess
+ *   at tstop, i.e., a coarse level or storage on level 0 (see
+ *   @ref braid_SetStorage).
+ *
+ * Otherwise, or when the needed history is not available, the default guess
+ * is used.  Extrapolation helps most in early iterations and where no guess is
+ * stored; once the stored values converge, they (and the correction
+ * predictor) are usually better.  Use @ref braid_StepStatusSetSolverIters and
+ * @ref braid_GetSolverIters to compare the predictors on each level.  Extrapolation keeps copies of the last one or two inputs on each
+ * level, the correction predictor keeps one vector per level.  Only used when
+ * XBraid chooses *ustop* itself, and not for adjoint runs or with shell
+ * vectors.  Setting *level* = -1 sets the default for all levels.
+ *
+ * Default is *braid_PRED_NONE*.
+ **/
+braid_Int
+braid_SetPredictor(braid_Core  core,          /**< braid_Core (_braid_Core) struct*/
+                   braid_Int   level,         /**< level to set the predictor on, -1 for all levels */
+                   braid_Int   ptype          /**< predictor type, see @ref predictors */
+                   );
+
+/**
+ * After Drive() finishes, this returns the number of steps on *level* for which
+ * the user's Step routine reported its solver iterations (see
+ * @ref braid_StepStatusSetSolverIters), and the average number of solver
+ * iterations per step, summed over all processors.  Comparing the average
+ * with and without a predictor (see @ref braid_SetPredictor) shows the
+ * iterations saved.
+ **/
+braid_Int
+braid_GetSolverIters(braid_Core   core,           /**< braid_Core (_braid_Core) struct*/
+                     braid_Int    level,          /**< input, level of interest */
+                     braid_Int   *nsteps_ptr,     /**< output, number of steps that reported solver iterations */
+                     braid_Real  *avg_iters_ptr   /**< output, average solver iterations per step (0 if none) */
+                     );
+
+/**
+ * Set the user routine that returns the size of a vector in bytes (see
+ * @ref braid_PtFcnVectorSize), used for the memory statistics of
+ * @ref braid_GetMemoryStats and @ref braid_PrintStats.  This is useful when
+ * the size varies, e.g., with spatial coarsening or shell vectors.
+ *
+ * Default is NULL, which counts each full vector with the size returned by
+ * the BufSize routine (plus the same again for its adjoint), and each shell
+ * vector with zero bytes.
+ **/
+braid_Int
+braid_SetVectorSize(braid_Core             core,    /**< braid_Core (_braid_Core) struct*/
+                    braid_PtFcnVectorSize  vsize    /**< vector size function, NULL for the default */
+                    );
+
+/**
+ * Returns the memory statistics of this processor, i.e., the number of live
+ * vectors and their estimated size in bytes (see @ref braid_SetVectorSize),
+ * now and at the peak, for *role* (see @ref memroles) on *level*.  Every
+ * vector created by XBraid is counted from creation to free, as well as the
+ * message buffers and the copies recorded for the adjoint.  Setting *level* =
+ * -1 or *role* = -1 sums over all levels or roles.  The peaks of a single
+ * level, or of all levels and roles, are exact.  Otherwise, the peak of a sum
+ * is the sum of the peaks, an upper bound.  @ref braid_PrintStats shows the
+ * peaks of each level and role, max over all processors.  Can be called at any
+ * time, e.g., from Access, to see how the memory depends on
+ * @ref braid_SetStorage and @ref braid_SetMaxLevels.
+ **/
+braid_Int
+braid_GetMemoryStats(braid_Core   core,             /**< braid_Core (_braid_Core) struct*/
+                     braid_Int    level,            /**< input, level of interest, -1 for all levels */
+                     braid_Int    role,             /**< input, role of interest, -1 for all roles */
+                     braid_Int   *nvectors_ptr,     /**< output, number of live vectors */
+                     braid_Real  *bytes_ptr,        /**< output, their size in bytes */
+                     braid_Int   *peak_nvectors_ptr,/**< output, peak number of live vectors */
+                     braid_Real  *peak_bytes_ptr    /**< output, peak size in bytes */
+                     );
+
+/**
+ * Predict the wall time of @ref braid_Drive on *nprocs* processors with the
+ * current settings, using the standard MGRIT cost model on the hierarchy that
+ * XBraid would build (including *min_coarse*, periodic problems and
+ * @ref braid_SetRelaxOnlyCG).  An iteration costs the time steps on the
+ * critical path of each relaxation, restriction and interpolation sweep, plus
+ * one message between neighboring processors per sweep and the residual norm
+ * reduction.  The coarsest level is a sequential sweep.  The number of
+ * iterations is the number needed to reach the tolerance with a constant
+ * convergence factor (an absolute tolerance is taken relative to the initial
+ * residual norm of the last @ref braid_Drive, if any).  The speedup is relative
+ * to sequential time stepping on the fine grid.
+ *
+ * The inputs are the measured costs:
+ * - *step_costs[l]* is the time of one Step on level *l*, for the first
+ *   *ncosts* levels.  Coarser levels use the last given cost.  If *ncosts* is
+ *   0, the costs measured by the last @ref braid_Drive with
+ *   @ref braid_SetAutoTune are used.  Costs of vector operations should be
+ *   included if significant, e.g., from @ref braid_TestPerformance.
+ * - A message takes *latency* seconds plus the BufSize bytes divided by
+ *   *bandwidth* (bytes per second).
+ * - *conv_factor* is the residual reduction per iteration.  If it is 0, the
+ *   average factor of the last @ref braid_Drive is used.
+ *
+ * The predicted time is -1 if the inputs are missing.  Can be called before
+ * or after @ref braid_Drive, also with a one-processor core to plan a run.
+ **/
+braid_Int
+braid_PredictTime(braid_Core   core,           /**< braid_Core (_braid_Core) struct*/
+                  braid_Int    nprocs,         /**< input, number of processors in time */
+                  braid_Int    ncosts,         /**< input, number of levels in *step_costs*, 0 for measured costs */
+                  braid_Real  *step_costs,     /**< input, seconds per Step on each level */
+                  braid_Real   latency,        /**< input, seconds per message */
+                  braid_Real   bandwidth,      /**< input, bytes per second, 0 to ignore the message size */
+                  braid_Real   conv_factor,    /**< input, convergence factor, 0 for the measured one */
+                  braid_Real  *time_ptr,       /**< output, predicted time to solution in seconds */
+                  braid_Real  *speedup_ptr,    /**< output, predicted speedup over sequential time stepping */
+                  braid_Int   *niter_ptr       /**< output, predicted number of iterations */
+                  );
+
+/**
+ * Rank configurations by the predicted time to solution of
+ * @ref braid_PredictTime (same inputs) and print the *nbest* best ones.  The
+ * candidates are the processor counts 1, 2, 4, ... up to *max_nprocs*, and each
+ * number of levels the hierarchy can have, with the current coarsening factors
+ * and relaxations.  These are kept because the convergence factor is only
+ * known for them, so compare other settings by calling this again with their
+ * measured convergence factors.  The hierarchy of the best configuration is
+ * printed as well.  Processor 0 prints.
+ **/
+braid_Int
+braid_AdviseConfig(braid_Core   core,          /**< braid_Core (_braid_Core) struct*/
+                   braid_Int    max_nprocs,    /**< input, max number of processors in time */
+                   braid_Int    ncosts,        /**< input, number of levels in *step_costs*, 0 for measured costs */
+                   braid_Real  *step_costs,    /**< input, seconds per Step on each level */
+                   braid_Real   latency,       /**< input, seconds per message */
+                   braid_Real   bandwidth,     /**< input, bytes per second, 0 to ignore the message size */
+                   braid_Real   conv_factor,   /**< input, convergence factor, 0 for the measured one */
+                   braid_Int    nbest          /**< input, number of configurations to print */
+                   );
+
 /**
  * After Drive() finishes, this returns the number of iterations taken.
  **/
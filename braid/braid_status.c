@@ -155,6 +155,15 @@ braid_StatusGetDone(braid_Status status,
    return _braid_error_flag;
 }
 
+braid_Int
+braid_StatusGetEnsembleActive(braid_Status   status,
+                              braid_Int    **active_ptr
+                              )
+{
+   *active_ptr = _braid_StatusElt(status, ens_active);
+   return _braid_error_flag;
+}
+
 braid_Int
 braid_StatusGetTIUL(braid_Status status,
                     braid_Int   *iloc_upper,
@@ -315,6 +324,9 @@ braid_StatusGetRNorms(braid_Status status,
    braid_Real *_rnorms    = _braid_StatusElt(status, rnorms);
    braid_Int   rnorms_len = _braid_StatusElt(status, niter) + 1;
 
+   /* Finish a pending residual norm reduction (see braid_SetLookahead) */
+   _braid_RNormWait((braid_Core)status);
+
    _braid_GetNEntries(_rnorms, rnorms_len, nrequest_ptr, rnorms_ptr);
    return _braid_error_flag;
 }
@@ -357,6 +369,15 @@ braid_StatusSetTightFineTolx(braid_Status status,
    return _braid_error_flag;
 }
 
+braid_Int
+braid_StatusSetSolverIters(braid_Status status,
+                           braid_Int    solver_iters
+                           )
+{
+   _braid_StatusElt(status, solver_iters) = solver_iters;
+   return _braid_error_flag;
+}
+
 braid_Int
 braid_StatusSetRFactor(braid_Status status,
                        braid_Real   rfactor
@@ -634,6 +655,7 @@ ACCESSOR_FUNCTION_GET1(Access, NRefine,         Int)
 ACCESSOR_FUNCTION_GET1(Access, NTPoints,        Int)
 ACCESSOR_FUNCTION_GET1(Access, Residual,        Real)
 ACCESSOR_FUNCTION_GET1(Access, Done,            Int)
+ACCESSOR_FUNCTION_GET1(Access, EnsembleActive,  Int*)
 ACCESSOR_FUNCTION_GET4(Access, TILD,            Real, Int, Int, Int)
 ACCESSOR_FUNCTION_GET1(Access, WrapperTest,     Int)
 ACCESSOR_FUNCTION_GET1(Access, CallingFunction, Int)
@@ -740,6 +762,7 @@ _braid_StepStatusInit(braid_Real       tstart,
    _braid_StatusElt(status, nrefine)   = nrefine;
    _braid_StatusElt(status, gupper)    = gupper;
    _braid_StatusElt(status, r_space)   = 0;
+   _braid_StatusElt(status, solver_iters) = -1;
 
    return _braid_error_flag;
 }
@@ -759,7 +782,9 @@ ACCESSOR_FUNCTION_SET1(Step, OldFineTolx,   Real)
 ACCESSOR_FUNCTION_SET1(Step, TightFineTolx, Real)
 ACCESSOR_FUNCTION_SET1(Step, RFactor,       Real)
 ACCESSOR_FUNCTION_SET1(Step, RSpace,        Real)
+ACCESSOR_FUNCTION_SET1(Step, SolverIters,   Int)
 ACCESSOR_FUNCTION_GET1(Step, Done,          Int)
+ACCESSOR_FUNCTION_GET1(Step, EnsembleActive, Int*)
 ACCESSOR_FUNCTION_GET1(Step, SingleErrorEstStep, Real)
 
 /*--------------------------------------------------------------------------
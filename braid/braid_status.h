@@ -227,6 +227,17 @@ braid_StatusGetDone(braid_Status status,                   /**< structure contai
                     braid_Int   *done_ptr                  /**< output,  =1 if XBraid has finished, else =0 */
                     );
 
+/**
+ * In ensemble mode (see braid_SetEnsemble), return the array of active flags
+ * of the ensemble members, where *(*active_ptr)[m] = 0* indicates that member
+ * *m* has converged.  Converged members must still be propagated by Step(),
+ * but may be treated more cheaply.  Returns NULL if ensemble mode is off.
+ **/
+braid_Int
+braid_StatusGetEnsembleActive(braid_Status   status,        /**< structure containing current simulation info */
+                              braid_Int    **active_ptr     /**< output, active flag of each ensemble member (do not free) */
+                              );
+
 /**
  * Returns upper and lower time point indices on this processor. Two
  * values are returned. Requires the user to specify which level they
@@ -432,6 +443,16 @@ braid_StatusSetTightFineTolx(braid_Status status,          /**< structure contai
                              braid_Real   tight_fine_tolx  /**< input, boolean indicating whether the tight tolx has been used */
                              );
 
+/**
+ * Set the number of iterations the implicit solver (e.g., Newton) took in this
+ * step.  XBraid sums these up on each level, for comparing predictors (see
+ * *braid_SetPredictor* and *braid_GetSolverIters*).
+ **/
+braid_Int
+braid_StatusSetSolverIters(braid_Status status,            /**< structure containing current simulation info */
+                           braid_Int    solver_iters       /**< input, number of solver iterations in this step */
+                           );
+
 /**
  * Set the rfactor, a desired refinement factor for this interval.  rfactor=1
  * indicates no refinement, otherwise, this inteval is subdivided rfactor
@@ -582,6 +603,7 @@ ACCESSOR_HEADER_GET1(Access, NRefine,         Int)
 ACCESSOR_HEADER_GET1(Access, NTPoints,        Int)
 ACCESSOR_HEADER_GET1(Access, Residual,        Real)
 ACCESSOR_HEADER_GET1(Access, Done,            Int)
+ACCESSOR_HEADER_GET1(Access, EnsembleActive,  Int*)
 ACCESSOR_HEADER_GET4(Access, TILD,            Real, Int, Int, Int)
 ACCESSOR_HEADER_GET1(Access, WrapperTest,     Int)
 ACCESSOR_HEADER_GET1(Access, CallingFunction, Int)
@@ -642,7 +664,9 @@ ACCESSOR_HEADER_SET1(Step, OldFineTolx,   Real)
 ACCESSOR_HEADER_SET1(Step, TightFineTolx, Real)
 ACCESSOR_HEADER_SET1(Step, RFactor,       Real)
 ACCESSOR_HEADER_SET1(Step, RSpace,        Real)
+ACCESSOR_HEADER_SET1(Step, SolverIters,   Int)
 ACCESSOR_HEADER_GET1(Step, Done,          Int)
+ACCESSOR_HEADER_GET1(Step, EnsembleActive, Int*)
 ACCESSOR_HEADER_GET1(Step, SingleErrorEstStep, Real)
 
 /*--------------------------------------------------------------------------
@@ -878,3 +878,354 @@ braid_TestAll( braid_App            app,
    
    return correct;
 }
+
+/*--------------------------------------------------------------------------
+ * Timing statistics for braid_TestPerformance: sum, min and max of the times
+ * of the individual calls, and the number of calls
+ *--------------------------------------------------------------------------*/
+
+typedef struct
+{
+   braid_Real  sum, min, max;
+   braid_Int   ncalls;
+
+} _braid_TestTimer;
+
+static void
+_braid_TestTimerAdd(_braid_TestTimer  *timer,
+                    braid_Real         time)
+{
+   if ( (timer->ncalls == 0) || (time < timer->min) )
+   {
+      timer->min = time;
+   }
+   if ( (timer->ncalls == 0) || (time > timer->max) )
+   {
+      timer->max = time;
+   }
+   timer->sum += time;
+   timer->ncalls++;
+}
+
+/* Print the timer statistics (max over comm_x, the slowest processor decides),
+ * and return the mean time per call.  If nbytes > 0, also print the throughput
+ * in MB/s for that many bytes per call. */
+static braid_Real
+_braid_TestTimerPrint(FILE              *fp,
+                      braid_Int          myid_x,
+                      MPI_Comm           comm_x,
+                      const char        *name,
+                      _braid_TestTimer  *timer,
+                      braid_Int          nbytes)
+{
+   braid_Real  lstats[3], gstats[3];
+
+   lstats[0] = (timer->ncalls > 0) ? timer->sum / timer->ncalls : 0.0;
+   lstats[1] = timer->min;
+   lstats[2] = timer->max;
+   MPI_Allreduce(lstats, gstats, 3, braid_MPI_REAL, MPI_MAX, comm_x);
+
+   if (timer->ncalls == 0)
+   {
+      return 0.0;
+   }
+   if ( (nbytes > 0) && (gstats[0] > 0.0) )
+   {
+      _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   %-16s %10.3e %10.3e %10.3e %10.3e %10.3e\n",
+                             name, gstats[0], gstats[1], gstats[2], 1.0/gstats[0], 1.0e-6*nbytes/gstats[0]);
+   }
+   else
+   {
+      _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   %-16s %10.3e %10.3e %10.3e %10.3e\n",
+                             name, gstats[0], gstats[1], gstats[2], (gstats[0] > 0.0) ? 1.0/gstats[0] : 0.0);
+   }
+
+   return gstats[0];
+}
+
+braid_Int
+braid_TestPerformance( braid_App            app,
+                       MPI_Comm                comm_x,
+                       FILE                    *fp, 
+                       braid_Real              t,
+                       braid_Real              fdt,
+                       braid_Real              cdt,
+                       braid_Int               nreps,
+                       braid_Int               ntime,
+                       braid_Int               cfactor,
+                       braid_Int               nrelax,
+                       braid_Int               niter,
+                       braid_PtFcnInit         myinit,
+                       braid_PtFcnFree         myfree,
+                       braid_PtFcnClone        clone,
+                       braid_PtFcnSum          sum,
+                       braid_PtFcnSpatialNorm  spatialnorm, 
+                       braid_PtFcnBufSize      bufsize,
+                       braid_PtFcnBufPack      bufpack,
+                       braid_PtFcnBufUnpack    bufunpack,
+                       braid_PtFcnSCoarsen     coarsen,
+                       braid_PtFcnSRefine      refine,
+                       braid_PtFcnResidual     residual,
+                       braid_PtFcnStep         step)
+{
+   braid_Vector            u, v, w, uc = NULL, vc = NULL;
+   braid_Real              start, result1, tseq, titer, tbest, speedup, best;
+   braid_Real              ct_init, ct_free, ct_sum, ct_clone, ct_norm, ct_pack, ct_unpack;
+   braid_Real              ct_fstep, ct_cstep, ct_coarsen, ct_refine, ct_msg, cl;
+   braid_Real              nl, fl, cpl, np;
+   braid_Int               myid_x, rep, size, msize, nlevels, level, nprocs, pbest;
+   void                   *buffer;
+   _braid_TestTimer        t_init, t_free, t_clone, t_sum, t_norm, t_size, t_pack, t_unpack;
+   _braid_TestTimer        t_fstep, t_cstep, t_res, t_coarsen, t_refine, t_scstep;
+   braid_Status            status  = _braid_CTAlloc(_braid_Status, 1);
+   braid_StepStatus        sstatus = (braid_StepStatus) status;
+   braid_CoarsenRefStatus  cstatus = (braid_CoarsenRefStatus) status;
+   braid_BufferStatus      bstatus = (braid_BufferStatus) status;
+
+   /* Set up the status like in braid_TestResidual(), so that the user may call
+    * braid_StepStatusSetRFactor() from inside of step() */
+   braid_Core              core    = (braid_Core) status;
+   _braid_Grid           **grids;
+   _braid_Grid            *fine_grid;
+   braid_Int              *rfactors;
+   grids     = _braid_CTAlloc(_braid_Grid *, 1);
+   fine_grid = _braid_CTAlloc(_braid_Grid, 1);
+   _braid_GridElt(fine_grid, ilower) = 0;
+   grids[0] = fine_grid;
+   _braid_CoreElt(core, grids) = grids;
+   rfactors = _braid_CTAlloc(braid_Int, 4); 
+   _braid_CoreElt(core, rfactors) = rfactors;
+
+   memset(&t_init,    0, sizeof(_braid_TestTimer));
+   memset(&t_free,    0, sizeof(_braid_TestTimer));
+   memset(&t_clone,   0, sizeof(_braid_TestTimer));
+   memset(&t_sum,     0, sizeof(_braid_TestTimer));
+   memset(&t_norm,    0, sizeof(_braid_TestTimer));
+   memset(&t_size,    0, sizeof(_braid_TestTimer));
+   memset(&t_pack,    0, sizeof(_braid_TestTimer));
+   memset(&t_unpack,  0, sizeof(_braid_TestTimer));
+   memset(&t_fstep,   0, sizeof(_braid_TestTimer));
+   memset(&t_cstep,   0, sizeof(_braid_TestTimer));
+   memset(&t_res,     0, sizeof(_braid_TestTimer));
+   memset(&t_coarsen, 0, sizeof(_braid_TestTimer));
+   memset(&t_refine,  0, sizeof(_braid_TestTimer));
+   memset(&t_scstep,  0, sizeof(_braid_TestTimer));
+
+   nreps   = _braid_max(nreps, 1);
+   cfactor = _braid_max(cfactor, 2);
+   nrelax  = _braid_max(nrelax, 0);
+   niter   = _braid_max(niter, 1);
+
+   MPI_Comm_rank( comm_x, &myid_x );
+
+   /* Print intro */
+   _braid_ParFprintfFlush(fp, myid_x, "\nStarting braid_TestPerformance\n\n");
+
+   /* Vector routines */
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   u = init(t=%1.2e), %d times\n", t, nreps);
+   myinit(app, t, &u);
+   clone(app, u, &v);
+   for (rep = 0; rep < nreps; rep++)
+   {
+      start = MPI_Wtime();
+      myinit(app, t, &w);
+      _braid_TestTimerAdd(&t_init, MPI_Wtime() - start);
+
+      start = MPI_Wtime();
+      myfree(app, w);
+      _braid_TestTimerAdd(&t_free, MPI_Wtime() - start);
+
+      start = MPI_Wtime();
+      clone(app, u, &w);
+      _braid_TestTimerAdd(&t_clone, MPI_Wtime() - start);
+
+      start = MPI_Wtime();
+      myfree(app, w);
+      _braid_TestTimerAdd(&t_free, MPI_Wtime() - start);
+
+      start = MPI_Wtime();
+      sum(app, 1.0, u, 0.5, v);
+      _braid_TestTimerAdd(&t_sum, MPI_Wtime() - start);
+
+      start = MPI_Wtime();
+      spatialnorm(app, v, &result1);
+      _braid_TestTimerAdd(&t_norm, MPI_Wtime() - start);
+   }
+
+   /* Buffer routines */
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   bufsize(), bufpack(u), bufunpack(), %d times\n", nreps);
+   _braid_BufferStatusInit(0, 0, bstatus);
+   bufsize(app, &size, bstatus);
+   buffer = malloc(size);
+   msize  = size;
+   for (rep = 0; rep < nreps; rep++)
+   {
+      _braid_BufferStatusInit(0, 0, bstatus);
+      start = MPI_Wtime();
+      bufsize(app, &size, bstatus);
+      _braid_TestTimerAdd(&t_size, MPI_Wtime() - start);
+
+      _braid_StatusElt(bstatus, size_buffer) = size;
+      start = MPI_Wtime();
+      bufpack(app, u, buffer, bstatus);
+      _braid_TestTimerAdd(&t_pack, MPI_Wtime() - start);
+      msize = _braid_StatusElt(bstatus, size_buffer);
+
+      start = MPI_Wtime();
+      bufunpack(app, buffer, &w, bstatus);
+      _braid_TestTimerAdd(&t_unpack, MPI_Wtime() - start);
+      myfree(app, w);
+   }
+   free(buffer);
+
+   /* Time steps on the fine and coarse time grids, restarting from u each time */
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   v = step(u, v) with fine dt=%1.2e and coarse dt=%1.2e, %d times\n",
+                          fdt, cdt, nreps);
+   for (rep = 0; rep < nreps; rep++)
+   {
+      sum(app, 1.0, u, 0.0, v);
+      _braid_StepStatusInit(t, t+fdt, 0, 1e-16, 0, 0, 0, 2, sstatus);
+      start = MPI_Wtime();
+      step(app, u, NULL, v, sstatus);
+      _braid_TestTimerAdd(&t_fstep, MPI_Wtime() - start);
+
+      if (residual != NULL)
+      {
+         clone(app, u, &w);
+         start = MPI_Wtime();
+         residual(app, v, w, sstatus);
+         _braid_TestTimerAdd(&t_res, MPI_Wtime() - start);
+         myfree(app, w);
+      }
+
+      sum(app, 1.0, u, 0.0, v);
+      _braid_StepStatusInit(t, t+cdt, 0, 1e-16, 0, 1, 0, 2, sstatus);
+      start = MPI_Wtime();
+      step(app, u, NULL, v, sstatus);
+      _braid_TestTimerAdd(&t_cstep, MPI_Wtime() - start);
+   }
+
+   /* Spatial coarsening and refinement, and time steps on coarsened vectors */
+   if ( (coarsen != NULL) && (refine != NULL) )
+   {
+      _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   uc = coarsen(u), refine(uc), step(uc, vc) with coarse dt, %d times\n", nreps);
+      _braid_CoarsenRefStatusInit(t, t-fdt, t+fdt, t-cdt, t+cdt, 0, 0, 0, 0, cstatus);
+      coarsen(app, u, &uc, cstatus);
+      clone(app, uc, &vc);
+      for (rep = 0; rep < nreps; rep++)
+      {
+         _braid_CoarsenRefStatusInit(t, t-fdt, t+fdt, t-cdt, t+cdt, 0, 0, 0, 0, cstatus);
+         start = MPI_Wtime();
+         coarsen(app, u, &w, cstatus);
+         _braid_TestTimerAdd(&t_coarsen, MPI_Wtime() - start);
+         myfree(app, w);
+
+         start = MPI_Wtime();
+         refine(app, uc, &w, cstatus);
+         _braid_TestTimerAdd(&t_refine, MPI_Wtime() - start);
+         myfree(app, w);
+
+         sum(app, 1.0, uc, 0.0, vc);
+         _braid_StepStatusInit(t, t+cdt, 0, 1e-16, 0, 1, 0, 2, sstatus);
+         start = MPI_Wtime();
+         step(app, uc, NULL, vc, sstatus);
+         _braid_TestTimerAdd(&t_scstep, MPI_Wtime() - start);
+      }
+      myfree(app, uc);
+      myfree(app, vc);
+   }
+
+   /* Print the results */
+   _braid_ParFprintfFlush(fp, myid_x, "\n   braid_TestPerformance:   bytes per message: %d (bufsize), %d (packed)\n\n", size, msize);
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   %-16s %10s %10s %10s %10s %10s\n",
+                          "routine", "mean (s)", "min (s)", "max (s)", "calls/s", "MB/s");
+   ct_init    = _braid_TestTimerPrint(fp, myid_x, comm_x, "init", &t_init, 0);
+   ct_free    = _braid_TestTimerPrint(fp, myid_x, comm_x, "free", &t_free, 0);
+   ct_clone   = _braid_TestTimerPrint(fp, myid_x, comm_x, "clone", &t_clone, 0);
+   ct_sum     = _braid_TestTimerPrint(fp, myid_x, comm_x, "sum", &t_sum, 0);
+   ct_norm    = _braid_TestTimerPrint(fp, myid_x, comm_x, "spatialnorm", &t_norm, 0);
+                _braid_TestTimerPrint(fp, myid_x, comm_x, "bufsize", &t_size, 0);
+   ct_pack    = _braid_TestTimerPrint(fp, myid_x, comm_x, "bufpack", &t_pack, msize);
+   ct_unpack  = _braid_TestTimerPrint(fp, myid_x, comm_x, "bufunpack", &t_unpack, msize);
+   ct_fstep   = _braid_TestTimerPrint(fp, myid_x, comm_x, "step (fine dt)", &t_fstep, 0);
+   ct_cstep   = _braid_TestTimerPrint(fp, myid_x, comm_x, "step (coarse dt)", &t_cstep, 0);
+                _braid_TestTimerPrint(fp, myid_x, comm_x, "residual", &t_res, 0);
+   ct_coarsen = _braid_TestTimerPrint(fp, myid_x, comm_x, "coarsen", &t_coarsen, 0);
+   ct_refine  = _braid_TestTimerPrint(fp, myid_x, comm_x, "refine", &t_refine, 0);
+   if (t_scstep.ncalls > 0)
+   {
+      ct_cstep = _braid_TestTimerPrint(fp, myid_x, comm_x, "step (coarsened)", &t_scstep, 0);
+   }
+
+   /*
+    * Predict the ideal speedup with a simple cost model.  On each level l but
+    * the coarsest, with N_l points, an iteration does nrelax+1 F-relaxations
+    * and nrelax C-relaxations, one F-relaxation and C-point residual in
+    * restriction, and one F-relaxation in interpolation.  With P processors, an
+    * F-relaxation costs max((m-1)N_l/(mP), m-1) steps and a C-relaxation
+    * max(N_l/(mP), 1) steps.  Each relaxation and transfer sends one message
+    * (pack plus unpack, network latency is not modeled), and restriction and
+    * interpolation coarsen and refine the C-points if spatial coarsening is
+    * used.  The coarsest level (at most m points) is solved sequentially.
+    * Level 0 steps cost a fine step, all other levels a coarse step.  Vector
+    * operations are included as a clone, sum and free per step.
+    */
+   ct_msg = ct_pack + ct_unpack;
+   nlevels = 1;
+   for (nl = ntime; nl > cfactor; nl = ceil(nl / cfactor))
+   {
+      nlevels++;
+   }
+   tseq  = ntime * ct_fstep;
+   best  = 0.0;
+   pbest = 1;
+   _braid_ParFprintfFlush(fp, myid_x, "\n   braid_TestPerformance:   predicted speedup for ntime = %d, cfactor = %d, nrelax = %d, %d iterations, %d levels\n",
+                          ntime, cfactor, nrelax, niter, nlevels);
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   %10s %12s %12s\n", "nprocs", "time (s)", "speedup");
+   for (nprocs = 1; nprocs <= ntime; nprocs *= 2)
+   {
+      np    = nprocs;
+      titer = 0.0;
+      nl    = ntime;
+      for (level = 0; level < nlevels-1; level++)
+      {
+         cl  = (level == 0) ? ct_fstep : ct_cstep;
+         cl += ct_clone + ct_sum + ct_free;
+         fl  = _braid_max((cfactor-1)*nl/(cfactor*np), cfactor-1);
+         cpl = _braid_max(nl/(cfactor*np), 1.0);
+         titer += ( (nrelax+3)*fl + (nrelax+1)*cpl ) * cl;
+         titer += (2*nrelax + 3) * ct_msg;
+         if (t_scstep.ncalls > 0)
+         {
+            titer += cpl * (ct_coarsen + ct_refine);
+         }
+         nl = ceil(nl / cfactor);
+      }
+      titer += nl * (ct_cstep + ct_clone + ct_sum + ct_free);
+      /* Residual norm at the fine grid C-points */
+      titer += _braid_max(ntime/(cfactor*np), 1.0) * ct_norm;
+      tbest  = niter * titer + (ntime/np) * (ct_init + ct_free);
+      speedup = (tbest > 0.0) ? tseq / tbest : 0.0;
+      if (speedup > best)
+      {
+         best  = speedup;
+         pbest = nprocs;
+      }
+      _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   %10d %12.3e %12.3e\n", nprocs, tbest, speedup);
+   }
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   sequential time stepping: %1.3e s\n", tseq);
+   _braid_ParFprintfFlush(fp, myid_x, "   braid_TestPerformance:   best predicted speedup %1.2f with %d processors\n\n", best, pbest);
+
+   /* Free variables */
+   myfree(app, u);
+   myfree(app, v);
+
+   _braid_StatusDestroy(status);
+   _braid_TFree(rfactors);
+   _braid_TFree(grids);
+   _braid_TFree(fine_grid);
+
+   _braid_ParFprintfFlush(fp, myid_x, "Finished braid_TestPerformance\n");
+
+   return 0;
+}
@@ -225,6 +225,49 @@ braid_TestAll( braid_App                app,         /**< User defined App struc
                braid_PtFcnStep          step         /**< Compute a time step with a braid_Vector */
                );
 
+/**
+ * Time the user routines, as a companion to braid_TestAll.\n
+ * Each routine is called *nreps* times on a vector initialized at time *t*,
+ * with time steps of size *fdt* and *cdt*, and on spatially coarsened vectors
+ * if *coarsen* and *refine* are given.  The mean, min and max time per call
+ * (max over *comm_x*), calls per second, and MB/s for the buffer routines are
+ * printed, together with the message size from bufsize and bufpack.
+ *
+ * These times are then used in a simple cost model of MGRIT with *cfactor*,
+ * *nrelax* and *niter* iterations for *ntime* time steps, and the ideal
+ * speedup over sequential time stepping is printed for increasing numbers of
+ * processors in time.  Network latency and bandwidth are not modeled, so the
+ * prediction is an upper bound, but it shows whether a model is worth
+ * parallelizing in time before running XBraid.
+ * - *residual*, *coarsen* and *refine* may be NULL
+ * - Returns 0
+ **/
+braid_Int
+braid_TestPerformance( braid_App                app,         /**< User defined App structure */
+                       MPI_Comm                 comm_x,      /**< Spatial communicator */
+                       FILE                    *fp,          /**< File pointer (could be stdout or stderr) for log messages*/
+                       braid_Real               t,           /**< Time value to initialize test vectors with*/
+                       braid_Real               fdt,         /**< Fine time step value */
+                       braid_Real               cdt,         /**< Coarse time step value */
+                       braid_Int                nreps,       /**< Number of calls to time for each routine */
+                       braid_Int                ntime,       /**< Number of time steps for the speedup prediction */
+                       braid_Int                cfactor,     /**< Coarsening factor for the speedup prediction */
+                       braid_Int                nrelax,      /**< Number of CF relaxations for the speedup prediction */
+                       braid_Int                niter,       /**< Expected number of XBraid iterations for the speedup prediction */
+                       braid_PtFcnInit          init,        /**< Initialize a braid_Vector on finest temporal grid*/
+                       braid_PtFcnFree          free,        /**< Free a braid_Vector*/
+                       braid_PtFcnClone         clone,       /**< Clone a braid_Vector */
+                       braid_PtFcnSum           sum,         /**< Compute vector sum of two braid_Vectors */
+                       braid_PtFcnSpatialNorm   spatialnorm, /**< Compute norm of a braid_Vector, this is a norm only over space */
+                       braid_PtFcnBufSize       bufsize,     /**< Computes size in bytes for one braid_Vector MPI buffer */
+                       braid_PtFcnBufPack       bufpack,     /**< Packs MPI buffer to contain one braid_Vector */
+                       braid_PtFcnBufUnpack     bufunpack,   /**< Unpacks MPI buffer into a braid_Vector */
+                       braid_PtFcnSCoarsen      coarsen,     /**< Spatially coarsen a vector. If NULL, not timed.*/
+                       braid_PtFcnSRefine       refine,      /**< Spatially refine a vector. If NULL, not timed.*/
+                       braid_PtFcnResidual      residual,    /**< Compute a residual given two consectuive braid_Vectors. If NULL, not timed. */
+                       braid_PtFcnStep          step         /**< Compute a time step with a braid_Vector */
+                       );
+
 /** @}*/
 
 #ifdef __cplusplus
@@ -0,0 +1,370 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free
+ * Software Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing checkpoint/restart of the fine-grid MGRIT state.
+ *
+ *  All processors in comm write one file with MPI-IO.  The file is indexed by
+ *  global time index, so it can be read back with a different number of
+ *  processors in time.  With spatial parallelism, each spatial rank writes its
+ *  own file, with its rank appended to the file name.  The layout is
+ *
+ *     braid_Int   header[_braid_CkptNHeader]    (see _braid_CkptHeader*)
+ *     braid_Real  rnorm0, full_rnorm0
+ *     braid_Real  rnorms[niter], full_rnorms[niter]
+ *     braid_Real  ta[gupper+1]
+ *     braid_Int   rfactors[gupper+1]
+ *     slot[gupper+1], each a braid_Int flag (1 if a u-vector follows) and
+ *                     the u-vector packed with bufpack
+ **/
+
+#include "_braid.h"
+#include "util.h"
+
+#define _braid_CkptMagic          0x42524149
+#define _braid_CkptVersion        1
+
+#define _braid_CkptHeaderMagic    0
+#define _braid_CkptHeaderVersion  1
+#define _braid_CkptHeaderGupper   2
+#define _braid_CkptHeaderNiter    3
+#define _braid_CkptHeaderNrefine  4
+#define _braid_CkptHeaderRstopped 5
+#define _braid_CkptHeaderBufsize  6
+#define _braid_CkptNHeader        8
+
+/*----------------------------------------------------------------------------
+ * Offsets in bytes of the sections of a checkpoint file
+ *----------------------------------------------------------------------------*/
+
+typedef struct
+{
+   MPI_Offset  rnorms;
+   MPI_Offset  ta;
+   MPI_Offset  rfactors;
+   MPI_Offset  slots;
+   MPI_Offset  slotsize;
+
+} _braid_CkptLayout;
+
+static void
+_braid_CkptGetLayout(braid_Int           gupper,
+                     braid_Int           niter,
+                     braid_Int           bufsize,
+                     _braid_CkptLayout  *layout)
+{
+   layout->rnorms   = _braid_CkptNHeader*sizeof(braid_Int) + 2*sizeof(braid_Real);
+   layout->ta       = layout->rnorms   + (MPI_Offset)(2*niter)*sizeof(braid_Real);
+   layout->rfactors = layout->ta       + (MPI_Offset)(gupper+1)*sizeof(braid_Real);
+   layout->slots    = layout->rfactors + (MPI_Offset)(gupper+1)*sizeof(braid_Int);
+   layout->slotsize = sizeof(braid_Int) + bufsize;
+}
+
+/*----------------------------------------------------------------------------
+ * Open the checkpoint file of this processor (collective over comm_world).
+ * With spatial parallelism, the processors with the same rank in comm share a
+ * file, and the file name gets the spatial rank appended.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_CkptOpen(braid_Core   core,
+                const char  *filename,
+                braid_Int    amode,
+                MPI_File    *fh_ptr)
+{
+   MPI_Comm   comm       = _braid_CoreElt(core, comm);
+   MPI_Comm   comm_world = _braid_CoreElt(core, comm_world);
+   MPI_Comm   comm_x;
+   braid_Int  myid, nprocs, nprocs_world, xid;
+   char      *name;
+
+   MPI_Comm_rank(comm, &myid);
+   MPI_Comm_size(comm, &nprocs);
+   MPI_Comm_size(comm_world, &nprocs_world);
+
+   name = _braid_TAlloc(char, strlen(filename)+16);
+   if (nprocs_world > nprocs)
+   {
+      MPI_Comm_split(comm_world, myid, _braid_CoreElt(core, myid_world), &comm_x);
+      MPI_Comm_rank(comm_x, &xid);
+      MPI_Comm_free(&comm_x);
+      sprintf(name, "%s.%05d", filename, xid);
+   }
+   else
+   {
+      strcpy(name, filename);
+   }
+
+   if (MPI_File_open(comm, name, amode, MPI_INFO_NULL, fh_ptr) != MPI_SUCCESS)
+   {
+      _braid_Error(braid_ERROR_GENERIC, "Cannot open checkpoint file");
+   }
+   _braid_TFree(name);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+braid_WriteCheckpoint(braid_Core   core,
+                      const char  *filename)
+{
+   MPI_Comm             comm     = _braid_CoreElt(core, comm);
+   braid_App            app      = _braid_CoreElt(core, app);
+   braid_Int            gupper   = _braid_CoreElt(core, gupper);
+   braid_Int            niter    = _braid_CoreElt(core, niter);
+   braid_Int           *rfactors = _braid_CoreElt(core, rfactors);
+   braid_BufferStatus   bstatus  = (braid_BufferStatus)core;
+   _braid_Grid        **grids    = _braid_CoreElt(core, grids);
+   braid_Int            header[_braid_CkptNHeader];
+   braid_Real           rnorm0s[2];
+   _braid_CkptLayout    layout;
+   MPI_File             fh;
+   braid_BaseVector     u;
+   braid_Int            myid, ilower, iupper, bufsize, i, iu, sflag;
+   braid_Real          *ta;
+   char                *slot;
+
+   if (grids[0] == NULL)
+   {
+      _braid_Error(braid_ERROR_GENERIC, "braid_WriteCheckpoint() called before braid_Drive()");
+      return _braid_error_flag;
+   }
+   ilower = _braid_GridElt(grids[0], ilower);
+   iupper = _braid_GridElt(grids[0], iupper);
+   ta     = _braid_GridElt(grids[0], ta);
+
+   MPI_Comm_rank(comm, &myid);
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   _braid_BaseBufSize(core, app,  &bufsize, bstatus);
+   if (niter > _braid_CoreElt(core, max_iter))
+   {
+      niter = _braid_CoreElt(core, max_iter);
+   }
+   _braid_CkptGetLayout(gupper, niter, bufsize, &layout);
+
+   _braid_CkptOpen(core, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, &fh);
+   MPI_File_set_size(fh, 0);
+
+   /* Header and residual history */
+   if (myid == 0)
+   {
+      for (i = 0; i < _braid_CkptNHeader; i++)
+      {
+         header[i] = 0;
+      }
+      header[_braid_CkptHeaderMagic]    = _braid_CkptMagic;
+      header[_braid_CkptHeaderVersion]  = _braid_CkptVersion;
+      header[_braid_CkptHeaderGupper]   = gupper;
+      header[_braid_CkptHeaderNiter]    = niter;
+      header[_braid_CkptHeaderNrefine]  = _braid_CoreElt(core, nrefine);
+      header[_braid_CkptHeaderRstopped] = _braid_CoreElt(core, rstopped);
+      header[_braid_CkptHeaderBufsize]  = bufsize;
+      rnorm0s[0] = _braid_CoreElt(core, rnorm0);
+      rnorm0s[1] = _braid_CoreElt(core, full_rnorm0);
+
+      MPI_File_write_at(fh, 0, header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+      MPI_File_write_at(fh, sizeof(header), rnorm0s, sizeof(rnorm0s), MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+      MPI_File_write_at(fh, layout.rnorms, _braid_CoreElt(core, rnorms),
+                        niter*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+      MPI_File_write_at(fh, layout.rnorms + niter*sizeof(braid_Real),
+                        _braid_CoreElt(core, full_rnorms),
+                        niter*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+   }
+
+   if (ilower <= iupper)
+   {
+      /* My slab of time values and refinement factors */
+      MPI_File_write_at(fh, layout.ta + (MPI_Offset)ilower*sizeof(braid_Real), ta,
+                        (iupper-ilower+1)*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+      MPI_File_write_at(fh, layout.rfactors + (MPI_Offset)ilower*sizeof(braid_Int), rfactors,
+                        (iupper-ilower+1)*sizeof(braid_Int), MPI_BYTE, MPI_STATUS_IGNORE);
+
+      /* My stored u-vectors, the other slots are left empty (flag 0) */
+      slot = _braid_CTAlloc(char, layout.slotsize);
+      for (i = ilower; i <= iupper; i++)
+      {
+         _braid_UGetIndex(core, 0, i, &iu, &sflag);
+         if (sflag == 0)
+         {
+            _braid_UGetVectorRef(core, 0, i, &u);
+            if (u != NULL)
+            {
+               *((braid_Int *) slot) = 1;
+               _braid_BufferStatusInit( 0, 0, bstatus );
+               _braid_BaseBufPack(core, app,  u, slot + sizeof(braid_Int), bstatus);
+               MPI_File_write_at(fh, layout.slots + (MPI_Offset)i*layout.slotsize, slot,
+                                 sizeof(braid_Int) + _braid_StatusElt(bstatus, size_buffer),
+                                 MPI_BYTE, MPI_STATUS_IGNORE);
+            }
+         }
+      }
+      _braid_TFree(slot);
+   }
+
+   MPI_File_close(&fh);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+braid_ReadCheckpoint(braid_Core   core,
+                     const char  *filename)
+{
+   braid_App            app       = _braid_CoreElt(core, app);
+   braid_Int            max_iter  = _braid_CoreElt(core, max_iter);
+   braid_BufferStatus   bstatus   = (braid_BufferStatus)core;
+   braid_Int            header[_braid_CkptNHeader];
+   braid_Real           rnorm0s[2];
+   _braid_CkptLayout    layout;
+   MPI_File             fh;
+   _braid_Grid         *grid;
+   braid_BaseVector     u;
+   braid_Int            ilower, iupper, gupper, niter, bufsize, i, iu, sflag;
+   braid_Int           *rfactors;
+   braid_Real          *ta;
+   char                *slot;
+
+   if (_braid_CoreElt(core, warm_restart))
+   {
+      _braid_Error(braid_ERROR_GENERIC, "braid_ReadCheckpoint() must be called before braid_Drive()");
+      return _braid_error_flag;
+   }
+   if (_braid_CoreElt(core, adjoint))
+   {
+      _braid_Error(braid_ERROR_GENERIC, "braid_ReadCheckpoint() does not support the adjoint");
+      return _braid_error_flag;
+   }
+
+   _braid_CkptOpen(core, filename, MPI_MODE_RDONLY, &fh);
+
+   /* Header and residual history */
+   MPI_File_read_at(fh, 0, header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+   MPI_File_read_at(fh, sizeof(header), rnorm0s, sizeof(rnorm0s), MPI_BYTE, MPI_STATUS_IGNORE);
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   _braid_BaseBufSize(core, app,  &bufsize, bstatus);
+   if ( (header[_braid_CkptHeaderMagic] != _braid_CkptMagic) ||
+        (header[_braid_CkptHeaderVersion] != _braid_CkptVersion) )
+   {
+      MPI_File_close(&fh);
+      _braid_Error(braid_ERROR_GENERIC, "Not a checkpoint file");
+      return _braid_error_flag;
+   }
+   if (header[_braid_CkptHeaderBufsize] > bufsize)
+   {
+      MPI_File_close(&fh);
+      _braid_Error(braid_ERROR_GENERIC, "Checkpoint vectors are larger than BufSize");
+      return _braid_error_flag;
+   }
+
+   gupper  = header[_braid_CkptHeaderGupper];
+   niter   = header[_braid_CkptHeaderNiter];
+   _braid_CkptGetLayout(gupper, niter, header[_braid_CkptHeaderBufsize], &layout);
+   if (niter > max_iter)
+   {
+      niter = max_iter;
+   }
+   MPI_File_read_at(fh, layout.rnorms, _braid_CoreElt(core, rnorms),
+                    niter*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+   MPI_File_read_at(fh, layout.rnorms + header[_braid_CkptHeaderNiter]*sizeof(braid_Real),
+                    _braid_CoreElt(core, full_rnorms),
+                    niter*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+
+   _braid_CoreElt(core, gupper)      = gupper;
+   _braid_CoreElt(core, nrefine)     = header[_braid_CkptHeaderNrefine];
+   _braid_CoreElt(core, rstopped)    = header[_braid_CkptHeaderRstopped];
+   _braid_CoreElt(core, rnorm0)      = rnorm0s[0];
+   _braid_CoreElt(core, full_rnorm0) = rnorm0s[1];
+   _braid_CoreElt(core, niter)       = niter;
+   _braid_CoreElt(core, ckpt_niter)  = niter;
+
+   /* Create the fine grid with the (possibly refined) time values of the
+    * checkpoint, distributed over the current processors */
+   _braid_GetDistribution(core, &ilower, &iupper);
+   _braid_GridInit(core, 0, ilower, iupper, &grid);
+   ta = _braid_GridElt(grid, ta);
+   if (ilower <= iupper)
+   {
+      MPI_File_read_at(fh, layout.ta + (MPI_Offset)ilower*sizeof(braid_Real), ta,
+                       (iupper-ilower+1)*sizeof(braid_Real), MPI_BYTE, MPI_STATUS_IGNORE);
+   }
+   _braid_InitHierarchy(core, grid, 0);
+
+   if (ilower <= iupper)
+   {
+      rfactors = _braid_CoreElt(core, rfactors);
+      MPI_File_read_at(fh, layout.rfactors + (MPI_Offset)ilower*sizeof(braid_Int), rfactors,
+                       (iupper-ilower+1)*sizeof(braid_Int), MPI_BYTE, MPI_STATUS_IGNORE);
+
+      /* Set the stored u-vectors from the checkpoint, or initialize them like
+       * _braid_InitGuess() if the checkpoint does not have them (for example,
+       * with a different storage option) */
+      slot = _braid_TAlloc(char, layout.slotsize);
+      for (i = ilower; i <= iupper; i++)
+      {
+         _braid_UGetIndex(core, 0, i, &iu, &sflag);
+         if (sflag == 0)
+         {
+            /* Slots past the end of the file are empty */
+            *((braid_Int *) slot) = 0;
+            MPI_File_read_at(fh, layout.slots + (MPI_Offset)i*layout.slotsize, slot,
+                             layout.slotsize, MPI_BYTE, MPI_STATUS_IGNORE);
+            if (*((braid_Int *) slot) == 1)
+            {
+               _braid_BufferStatusInit( 0, 0, bstatus );
+               _braid_BaseBufUnpack(core, app, slot + sizeof(braid_Int), &u, bstatus);
+            }
+            else
+            {
+               _braid_BaseInit(core, app,  ta[i-ilower], &u);
+            }
+            _braid_USetVectorRef(core, 0, i, u);
+         }
+         else if (sflag == -1)
+         {
+            _braid_BaseSInit(core,  app, ta[i-ilower], &u);
+            _braid_USetVectorRef(core, 0, i, u);
+         }
+      }
+      _braid_TFree(slot);
+   }
+
+   MPI_File_close(&fh);
+
+   /* braid_Drive() continues from here instead of initializing the grids */
+   _braid_CoreElt(core, warm_restart) = 1;
+
+   if ( (_braid_CoreElt(core, myid_world) == 0) && (_braid_CoreElt(core, print_level) > 0) )
+   {
+      _braid_printf("\n  Braid: Restart from checkpoint %s, %d time steps, iteration %d\n",
+                    filename, gupper, niter);
+   }
+
+   return _braid_error_flag;
+}
+
@@ -0,0 +1,431 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC. 
+ * Produced at the Lawrence Livermore National Laboratory.
+ * 
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ * 
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing the codec layer for vector messages.  Packed
+ *  buffers from the user's bufpack routine are (optionally) compressed before
+ *  they are handed to MPI, and decompressed before bufunpack.
+ *
+ *  Every message on a level with compression turned on starts with a small
+ *  header of two braid_Ints: the codec id and the uncompressed (packed) size.
+ *  The codec ids are
+ *     0 : raw, the packed buffer follows uncompressed
+ *     1 : built-in byte-shuffle + LZ codec
+ *     2 : user codec set with braid_SetCodec()
+ **/
+
+#include "_braid.h"
+#include "util.h"
+
+#define _braid_CodecRaw      0
+#define _braid_CodecBuiltin  1
+#define _braid_CodecUser     2
+
+/* Parameters for the built-in LZ codec */
+#define _braid_LZHashBits    12
+#define _braid_LZMinMatch    4
+#define _braid_LZMaxOffset   65535
+
+/*----------------------------------------------------------------------------
+ * Byte-shuffle (transpose) the bytes of an array of braid_Reals, so that the
+ * exponent and high mantissa bytes of neighboring values are stored next to
+ * each other.  Trailing bytes that do not form a full braid_Real are copied.
+ *----------------------------------------------------------------------------*/
+
+static void
+_braid_CodecShuffle(unsigned char *in,
+                    braid_Int      size,
+                    unsigned char *out,
+                    braid_Int      unshuffle)
+{
+   braid_Int  width = sizeof(braid_Real);
+   braid_Int  nelem = size / width;
+   braid_Int  b, i;
+
+   for (b = 0; b < width; b++)
+   {
+      for (i = 0; i < nelem; i++)
+      {
+         if (unshuffle)
+         {
+            out[i*width + b] = in[b*nelem + i];
+         }
+         else
+         {
+            out[b*nelem + i] = in[i*width + b];
+         }
+      }
+   }
+   for (i = nelem*width; i < size; i++)
+   {
+      out[i] = in[i];
+   }
+}
+
+/*----------------------------------------------------------------------------
+ * Variable length integer coding for the LZ codec.  Returns the new position,
+ * or -1 if the output/input capacity is exceeded.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_LZPutVarint(unsigned char *out,
+                   braid_Int      pos,
+                   braid_Int      cap,
+                   braid_Int      val)
+{
+   while (val >= 0x80)
+   {
+      if (pos >= cap) return -1;
+      out[pos++] = (unsigned char) ((val & 0x7f) | 0x80);
+      val >>= 7;
+   }
+   if (pos >= cap) return -1;
+   out[pos++] = (unsigned char) val;
+
+   return pos;
+}
+
+static braid_Int
+_braid_LZGetVarint(unsigned char *in,
+                   braid_Int      pos,
+                   braid_Int      cap,
+                   braid_Int     *val_ptr)
+{
+   braid_Int  val = 0, shift = 0;
+
+   while (1)
+   {
+      if ((pos >= cap) || (shift > 28)) return -1;
+      val |= ((braid_Int) (in[pos] & 0x7f)) << shift;
+      if ( !(in[pos++] & 0x80) ) break;
+      shift += 7;
+   }
+   *val_ptr = val;
+
+   return pos;
+}
+
+/*----------------------------------------------------------------------------
+ * LZ77-style compression.  The stream is a sequence of (literal length,
+ * literals, match length - MinMatch, match offset) records, where the last
+ * record holds only literals.  Returns the compressed size, or -1 if it does
+ * not fit into *cap* bytes.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_LZCompress(unsigned char *in,
+                  braid_Int      size,
+                  unsigned char *out,
+                  braid_Int      cap)
+{
+   braid_Int     table[1 << _braid_LZHashBits];
+   braid_Int     ip = 0, op = 0, anchor = 0;
+   braid_Int     ref, len, h;
+   unsigned int  seq;
+
+   for (h = 0; h < (1 << _braid_LZHashBits); h++)
+   {
+      table[h] = -1;
+   }
+
+   while (ip + _braid_LZMinMatch <= size)
+   {
+      memcpy(&seq, &in[ip], sizeof(seq));
+      h   = (braid_Int) ((seq * 2654435761U) >> (32 - _braid_LZHashBits));
+      ref = table[h];
+      table[h] = ip;
+
+      if ( (ref > -1) && (ip - ref <= _braid_LZMaxOffset) &&
+           (memcmp(&in[ref], &in[ip], _braid_LZMinMatch) == 0) )
+      {
+         len = _braid_LZMinMatch;
+         while ( (ip + len < size) && (in[ref + len] == in[ip + len]) )
+         {
+            len++;
+         }
+
+         /* Literals, then the match */
+         op = _braid_LZPutVarint(out, op, cap, ip - anchor);
+         if ( (op < 0) || (op + (ip - anchor) > cap) ) return -1;
+         memcpy(&out[op], &in[anchor], (ip - anchor));
+         op += (ip - anchor);
+         op = _braid_LZPutVarint(out, op, cap, len - _braid_LZMinMatch);
+         if (op < 0) return -1;
+         op = _braid_LZPutVarint(out, op, cap, ip - ref);
+         if (op < 0) return -1;
+
+         ip    += len;
+         anchor = ip;
+      }
+      else
+      {
+         ip++;
+      }
+   }
+
+   /* Trailing literals */
+   op = _braid_LZPutVarint(out, op, cap, size - anchor);
+   if ( (op < 0) || (op + (size - anchor) > cap) ) return -1;
+   memcpy(&out[op], &in[anchor], (size - anchor));
+   op += (size - anchor);
+
+   return op;
+}
+
+/*----------------------------------------------------------------------------
+ * Inverse of _braid_LZCompress.  Returns 0 on success and -1 if the stream is
+ * corrupt or does not decode to exactly *size* bytes.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_LZDecompress(unsigned char *in,
+                    braid_Int      insize,
+                    unsigned char *out,
+                    braid_Int      size)
+{
+   braid_Int  ip = 0, op = 0;
+   braid_Int  len, offset;
+
+   while (1)
+   {
+      ip = _braid_LZGetVarint(in, ip, insize, &len);
+      if ( (ip < 0) || (ip + len > insize) || (op + len > size) ) return -1;
+      memcpy(&out[op], &in[ip], len);
+      ip += len;
+      op += len;
+
+      if (op == size)
+      {
+         break;
+      }
+
+      ip = _braid_LZGetVarint(in, ip, insize, &len);
+      if (ip < 0) return -1;
+      ip = _braid_LZGetVarint(in, ip, insize, &offset);
+      if (ip < 0) return -1;
+      len += _braid_LZMinMatch;
+      if ( (offset < 1) || (offset > op) || (op + len > size) ) return -1;
+
+      /* Byte-wise copy, because the match may overlap the output */
+      while (len-- > 0)
+      {
+         out[op] = out[op - offset];
+         op++;
+      }
+   }
+
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecGetMinSize(braid_Core  core,
+                       braid_Int   level,
+                       braid_Int  *min_size_ptr)
+{
+   braid_Int  *comp_sizes = _braid_CoreElt(core, comp_sizes);
+   braid_Int   min_size   = -1;
+
+   if ( _braid_CoreElt(core, compress) )
+   {
+      min_size = _braid_CoreElt(core, comp_size_default);
+      if ( (level < _braid_CoreElt(core, max_levels)) && (comp_sizes[level] > -2) )
+      {
+         min_size = comp_sizes[level];
+      }
+   }
+   *min_size_ptr = min_size;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecBufSize(braid_Core  core,
+                    braid_Int   level,
+                    braid_Int  *size_ptr)
+{
+   braid_Int  min_size;
+
+   _braid_CodecGetMinSize(core, level, &min_size);
+   if (min_size > -1)
+   {
+      *size_ptr += _braid_CodecHeaderSize;
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Write the header and the (possibly compressed) payload of 'raw' to 'buffer'.
+ * Buffers smaller than 'min_size' are not compressed (-1: never compress).
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_CodecEncodeBuffer(braid_Core  core,
+                         braid_Int   min_size,
+                         void       *raw,
+                         braid_Int   raw_size,
+                         void       *buffer,
+                         braid_Int  *size_ptr)
+{
+   braid_App             app         = _braid_CoreElt(core, app);
+   braid_PtFcnCompress   compressfcn = _braid_CoreElt(core, compressfcn);
+   braid_Int            *header      = (braid_Int *) buffer;
+   unsigned char        *payload     = (unsigned char *) buffer + _braid_CodecHeaderSize;
+   unsigned char        *shuffled;
+   braid_Int             codec, size;
+
+   codec = _braid_CodecRaw;
+   size  = -1;
+   if ( (min_size > -1) && (raw_size >= min_size) && (raw_size > 0) )
+   {
+      /* Only accept output that is strictly smaller than the raw buffer */
+      if (compressfcn != NULL)
+      {
+         codec = _braid_CodecUser;
+         size  = raw_size - 1;
+         compressfcn(app, raw, raw_size, payload, &size);
+      }
+      else
+      {
+         codec    = _braid_CodecBuiltin;
+         shuffled = _braid_TAlloc(unsigned char, raw_size);
+         _braid_CodecShuffle((unsigned char *) raw, raw_size, shuffled, 0);
+         size = _braid_LZCompress(shuffled, raw_size, payload, raw_size - 1);
+         _braid_TFree(shuffled);
+      }
+   }
+   if ( (size < 0) || (size >= raw_size) )
+   {
+      /* Not compressed, store the packed buffer as is */
+      codec = _braid_CodecRaw;
+      size  = raw_size;
+      memcpy(payload, raw, raw_size);
+   }
+
+   header[0] = codec;
+   header[1] = raw_size;
+   *size_ptr = size + _braid_CodecHeaderSize;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecEncode(braid_Core  core,
+                   braid_Int   level,
+                   void       *raw,
+                   braid_Int   raw_size,
+                   void       *buffer,
+                   braid_Int  *size_ptr)
+{
+   braid_Real  *comp_stats = _braid_CoreElt(core, comp_stats);
+   braid_Int    min_size;
+
+   _braid_CodecGetMinSize(core, level, &min_size);
+   _braid_CodecEncodeBuffer(core, min_size, raw, raw_size, buffer, size_ptr);
+
+   comp_stats[0] += 1.0;
+   comp_stats[1] += (braid_Real) raw_size;
+   comp_stats[2] += (braid_Real) (*size_ptr);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecCompress(braid_Core  core,
+                     void       *raw,
+                     braid_Int   raw_size,
+                     void       *buffer,
+                     braid_Int  *size_ptr)
+{
+   _braid_CodecEncodeBuffer(core, 0, raw, raw_size, buffer, size_ptr);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecDecode(braid_Core  core,
+                   void       *buffer,
+                   braid_Int   size,
+                   void       *raw,
+                   braid_Int  *raw_size_ptr)
+{
+   braid_App               app           = _braid_CoreElt(core, app);
+   braid_PtFcnDecompress   decompressfcn = _braid_CoreElt(core, decompressfcn);
+   braid_Int              *header        = (braid_Int *) buffer;
+   unsigned char          *payload       = (unsigned char *) buffer + _braid_CodecHeaderSize;
+   unsigned char          *shuffled;
+   braid_Int               codec         = header[0];
+   braid_Int               raw_size      = header[1];
+
+   size -= _braid_CodecHeaderSize;
+   if (codec == _braid_CodecRaw)
+   {
+      memcpy(raw, payload, raw_size);
+   }
+   else if (codec == _braid_CodecUser)
+   {
+      decompressfcn(app, payload, size, raw, raw_size);
+   }
+   else
+   {
+      shuffled = _braid_TAlloc(unsigned char, raw_size);
+      if (_braid_LZDecompress(payload, size, shuffled, raw_size) != 0)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "Corrupt compressed message");
+      }
+      _braid_CodecShuffle(shuffled, raw_size, (unsigned char *) raw, 1);
+      _braid_TFree(shuffled);
+   }
+   *raw_size_ptr = raw_size;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CodecReduceStats(braid_Core  core)
+{
+   MPI_Comm    comm_world  = _braid_CoreElt(core, comm_world);
+   braid_Real *comp_stats  = _braid_CoreElt(core, comp_stats);
+   braid_Real *comp_gstats = _braid_CoreElt(core, comp_gstats);
+
+   MPI_Allreduce(comp_stats, comp_gstats, 3, braid_MPI_REAL, MPI_SUM, comm_world);
+
+   return _braid_error_flag;
+}
@@ -22,6 +22,213 @@
 #include "_braid.h"
 #include "util.h"
 
+/* The shared-memory transport needs MPI-3 shared-memory windows */
+#if !defined(braid_SEQUENTIAL) && defined(MPI_VERSION) && (MPI_VERSION >= 3)
+#define _braid_SHMEM 1
+#else
+#define _braid_SHMEM 0
+#endif
+
+/* Each shared-memory message slot starts with a cache line holding the flag
+ * (1 if the slot holds a message) */
+#define _braid_ShmHeaderSize 64
+#define _braid_ShmFlag(slot) ( ((volatile braid_Int *)(slot))[0] )
+#define _braid_ShmData(slot) ( (void *)((char *)(slot) + _braid_ShmHeaderSize) )
+
+/*----------------------------------------------------------------------------
+ * Returns the shared-memory message slot of processor 'proc' on 'level', or
+ * NULL if 'proc' is not on my node (or the transport is off)
+ *----------------------------------------------------------------------------*/
+
+static void *
+_braid_CommShmSlot(braid_Core  core,
+                   braid_Int   level,
+                   braid_Int   proc)
+{
+   braid_Int  *shm_ranks = _braid_CoreElt(core, shm_ranks);
+
+   if ( (shm_ranks == NULL) || (level >= _braid_CoreElt(core, shm_nslots)) ||
+        (shm_ranks[proc] < 0) )
+   {
+      return NULL;
+   }
+
+   return (_braid_CoreElt(core, shm_bases)[shm_ranks[proc]] +
+           level*_braid_CoreElt(core, shm_slotsize));
+}
+
+/*----------------------------------------------------------------------------
+ * Wait until the flag of a shared-memory message slot equals 'value'
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_CommShmSpin(braid_Core  core,
+                   void       *slot,
+                   braid_Int   value)
+{
+#if _braid_SHMEM
+   MPI_Comm   comm = _braid_CoreElt(core, comm);
+   MPI_Win    win  = _braid_CoreElt(core, shm_win);
+   int        flag;
+
+   MPI_Win_sync(win);
+   while (_braid_ShmFlag(slot) != value)
+   {
+      /* Keep other outstanding MPI messages progressing */
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, MPI_STATUS_IGNORE);
+      MPI_Win_sync(win);
+   }
+#endif
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Set the flag of a shared-memory message slot, after all prior writes to
+ * the slot are visible to the other processors on the node
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_CommShmSetFlag(braid_Core  core,
+                      void       *slot,
+                      braid_Int   value)
+{
+#if _braid_SHMEM
+   MPI_Win    win  = _braid_CoreElt(core, shm_win);
+
+   MPI_Win_sync(win);
+   _braid_ShmFlag(slot) = value;
+   MPI_Win_sync(win);
+#endif
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CommShmInit(braid_Core  core)
+{
+#if _braid_SHMEM
+   MPI_Comm            comm     = _braid_CoreElt(core, comm);
+   braid_Int           myid     = _braid_CoreElt(core, myid);
+   braid_Int           nlevels  = _braid_CoreElt(core, nlevels);
+   braid_App           app      = _braid_CoreElt(core, app);
+   braid_BufferStatus  bstatus  = (braid_BufferStatus)core;
+   MPI_Comm            shm_comm;
+   MPI_Win             shm_win;
+   MPI_Group           group, shm_group;
+   MPI_Aint            winsize;
+   braid_Int          *shm_ranks, *ranks;
+   char              **shm_bases, *base;
+   braid_Int           nprocs, shm_nprocs, size, slotsize, p, renew, grenew;
+   int                 disp_unit, shm_myid;
+
+   if ( !_braid_CoreElt(core, shmem) )
+   {
+      return _braid_error_flag;
+   }
+
+   /* One message slot per level, rounded up to a multiple of the header size */
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   _braid_BaseBufSize(core, app,  &size, bstatus);
+   slotsize = _braid_ShmHeaderSize +
+      ((size + _braid_ShmHeaderSize - 1) / _braid_ShmHeaderSize) * _braid_ShmHeaderSize;
+
+   /* The hierarchy may have changed.  Keep the window if its slots still fit
+    * on all processors (e.g., after a refinement), and just clear my slots. */
+   if (_braid_CoreElt(core, shm_ranks) != NULL)
+   {
+      renew = (nlevels > _braid_CoreElt(core, shm_nslots)) ||
+         (slotsize > _braid_CoreElt(core, shm_slotsize));
+      MPI_Allreduce(&renew, &grenew, 1, braid_MPI_INT, MPI_MAX, comm);
+      if (!grenew)
+      {
+         shm_comm = _braid_CoreElt(core, shm_comm);
+         shm_win  = _braid_CoreElt(core, shm_win);
+         MPI_Comm_rank(shm_comm, &shm_myid);
+         memset(_braid_CoreElt(core, shm_bases)[shm_myid], 0,
+                (size_t) _braid_CoreElt(core, shm_nslots) * _braid_CoreElt(core, shm_slotsize));
+         MPI_Win_sync(shm_win);
+         MPI_Barrier(shm_comm);
+         MPI_Win_sync(shm_win);
+         return _braid_error_flag;
+      }
+   }
+   _braid_CommShmDestroy(core);
+
+   MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myid, MPI_INFO_NULL, &shm_comm);
+   MPI_Comm_size(comm, &nprocs);
+   MPI_Comm_size(shm_comm, &shm_nprocs);
+
+   /* Map ranks in comm to ranks in shm_comm */
+   ranks     = _braid_TAlloc(braid_Int, nprocs);
+   shm_ranks = _braid_TAlloc(braid_Int, nprocs);
+   for (p = 0; p < nprocs; p++)
+   {
+      ranks[p] = p;
+   }
+   MPI_Comm_group(comm, &group);
+   MPI_Comm_group(shm_comm, &shm_group);
+   MPI_Group_translate_ranks(group, nprocs, ranks, shm_group, shm_ranks);
+   for (p = 0; p < nprocs; p++)
+   {
+      if (shm_ranks[p] == MPI_UNDEFINED)
+      {
+         shm_ranks[p] = -1;
+      }
+   }
+   MPI_Group_free(&group);
+   MPI_Group_free(&shm_group);
+   _braid_TFree(ranks);
+
+   winsize  = (MPI_Aint) nlevels * slotsize;
+   MPI_Win_allocate_shared(winsize, 1, MPI_INFO_NULL, shm_comm, &base, &shm_win);
+   MPI_Win_lock_all(MPI_MODE_NOCHECK, shm_win);
+   memset(base, 0, winsize);
+   MPI_Win_sync(shm_win);
+   MPI_Barrier(shm_comm);
+   MPI_Win_sync(shm_win);
+
+   shm_bases = _braid_TAlloc(char *, shm_nprocs);
+   for (p = 0; p < shm_nprocs; p++)
+   {
+      MPI_Win_shared_query(shm_win, p, &winsize, &disp_unit, &shm_bases[p]);
+   }
+
+   _braid_CoreElt(core, shm_comm)     = shm_comm;
+   _braid_CoreElt(core, shm_win)      = shm_win;
+   _braid_CoreElt(core, shm_ranks)    = shm_ranks;
+   _braid_CoreElt(core, shm_bases)    = shm_bases;
+   _braid_CoreElt(core, shm_nslots)   = nlevels;
+   _braid_CoreElt(core, shm_slotsize) = slotsize;
+#endif
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CommShmDestroy(braid_Core  core)
+{
+#if _braid_SHMEM
+   if (_braid_CoreElt(core, shm_ranks) != NULL)
+   {
+      MPI_Win_unlock_all(_braid_CoreElt(core, shm_win));
+      MPI_Win_free(&_braid_CoreElt(core, shm_win));
+      MPI_Comm_free(&_braid_CoreElt(core, shm_comm));
+      _braid_TFree(_braid_CoreElt(core, shm_ranks));
+      _braid_TFree(_braid_CoreElt(core, shm_bases));
+      _braid_CoreElt(core, shm_nslots) = 0;
+   }
+#endif
+
+   return _braid_error_flag;
+}
+
 /*----------------------------------------------------------------------------
  *----------------------------------------------------------------------------*/
 
@@ -38,18 +245,49 @@ _braid_CommRecvInit(braid_Core           core,
    void               *buffer;
    MPI_Request        *requests;
    MPI_Status         *status;
-   braid_Int           proc, size, num_requests;
+   braid_Int           proc, size, num_requests, min_size;
    braid_BufferStatus bstatus = (braid_BufferStatus)core;
 
    _braid_GetProc(core, level, index, &proc);
-   if (proc > -1)
+   if (proc == _braid_CoreElt(core, myid))
+   {
+      /* Message to myself, CommSendInit leaves a copy of the vector in the grid */
+      handle = _braid_CTAlloc(_braid_CommHandle, 1);
+      status = _braid_CTAlloc(MPI_Status, 1);
+      status[0].MPI_SOURCE = proc;
+
+      _braid_CommHandleElt(handle, request_type) = 1; /* recv type = 1 */
+      _braid_CommHandleElt(handle, num_requests) = 0;
+      _braid_CommHandleElt(handle, status)       = status;
+      _braid_CommHandleElt(handle, vector_ptr)   = vector_ptr;
+      _braid_CommHandleElt(handle, self_msg)     =
+         &_braid_GridElt(_braid_CoreElt(core, grids)[level], self_msg);
+   }
+   else if ( (proc > -1) && (_braid_CommShmSlot(core, level, proc) != NULL) )
+   {
+      /* The sender is on my node and packs directly into my slot */
+      handle = _braid_CTAlloc(_braid_CommHandle, 1);
+      status = _braid_CTAlloc(MPI_Status, 1);
+      status[0].MPI_SOURCE = proc;
+
+      _braid_CommHandleElt(handle, request_type) = 1; /* recv type = 1 */
+      _braid_CommHandleElt(handle, num_requests) = 0;
+      _braid_CommHandleElt(handle, status)       = status;
+      _braid_CommHandleElt(handle, vector_ptr)   = vector_ptr;
+      _braid_CommHandleElt(handle, shm_slot)     =
+         _braid_CommShmSlot(core, level, _braid_CoreElt(core, myid));
+   }
+   else if (proc > -1)
    {
       handle = _braid_TAlloc(_braid_CommHandle, 1);
 
       /* Allocate buffer through user routine */
       _braid_BufferStatusInit( 0, 0, bstatus );
       _braid_BaseBufSize(core, app,  &size, bstatus);
+      _braid_CodecGetMinSize(core, level, &min_size);
+      _braid_CodecBufSize(core, level, &size);
       buffer = malloc(size);
+      _braid_MemCount(core, level, braid_MEM_COMM, 1, size);
 
       num_requests = 1;
       requests = _braid_CTAlloc(MPI_Request, num_requests);
@@ -61,7 +299,17 @@ _braid_CommRecvInit(braid_Core           core,
       _braid_CommHandleElt(handle, requests)     = requests;
       _braid_CommHandleElt(handle, status)       = status;
       _braid_CommHandleElt(handle, buffer)       = buffer;
+      _braid_CommHandleElt(handle, buffer_size)  = size;
       _braid_CommHandleElt(handle, vector_ptr)   = vector_ptr;
+      _braid_CommHandleElt(handle, encoded)      = (min_size > -1);
+      _braid_CommHandleElt(handle, shm_slot)     = NULL;
+      _braid_CommHandleElt(handle, self_msg)     = NULL;
+   }
+
+   if (handle != NULL)
+   {
+      _braid_CommHandleElt(handle, level) = level;
+      _braid_CommHandleElt(handle, index) = index;
    }
 
    *handle_ptr = handle;
@@ -85,12 +333,42 @@ _braid_CommSendInit(braid_Core           core,
    void               *buffer;
    MPI_Request        *requests;
    MPI_Status         *status;
-   braid_Int           proc, size, num_requests;
+   braid_Int           proc, size, num_requests, min_size;
    braid_BufferStatus  bstatus   = (braid_BufferStatus)core;
-   
+   void               *slot;
+   braid_Real          ttime = 0.0;
+
+   _braid_TraceBegin(core, &ttime);
 
    _braid_GetProc(core, level, index+1, &proc);
-   if (proc > -1)
+   slot = NULL;
+   if ( (proc > -1) && (proc != _braid_CoreElt(core, myid)) )
+   {
+      slot = _braid_CommShmSlot(core, level, proc);
+   }
+
+   if (proc == _braid_CoreElt(core, myid))
+   {
+      /* Message to myself (periodic wrap-around), so skip the buffer and just
+       * copy the vector.  No handle is needed. */
+      _braid_BaseClone(core, app,  vector,
+                       &_braid_GridElt(_braid_CoreElt(core, grids)[level], self_msg));
+   }
+   else if (slot != NULL)
+   {
+      /* The receiver is on my node, so pack directly into its slot once the
+       * previous message has been picked up.  No handle is needed. */
+      _braid_CommShmSpin(core, slot, 0);
+
+      _braid_BufferStatusInit( 0, 0, bstatus );
+      _braid_BaseBufSize(core, app,  &size, bstatus);
+      _braid_StatusElt(bstatus, send_recv_rank) = proc;
+      _braid_StatusElt(bstatus, size_buffer) = size;
+      _braid_BaseBufPack(core, app,  vector, _braid_ShmData(slot), bstatus);
+
+      _braid_CommShmSetFlag(core, slot, 1);
+   }
+   else if (proc > -1)
    {
       handle = _braid_TAlloc(_braid_CommHandle, 1);
 
@@ -107,6 +385,17 @@ _braid_CommSendInit(braid_Core           core,
       _braid_BaseBufPack(core, app,  vector, buffer, bstatus);
       size = _braid_StatusElt( bstatus, size_buffer );
 
+      /* Pass the packed buffer through the codec layer */
+      _braid_CodecGetMinSize(core, level, &min_size);
+      if (min_size > -1)
+      {
+         void *raw = buffer;
+         buffer = malloc(size + _braid_CodecHeaderSize);
+         _braid_CodecEncode(core, level, raw, size, buffer, &size);
+         _braid_TFree(raw);
+      }
+      _braid_MemCount(core, level, braid_MEM_COMM, 1, size);
+
       num_requests = 1;
       requests = _braid_CTAlloc(MPI_Request, num_requests);
       status   = _braid_CTAlloc(MPI_Status, num_requests);
@@ -117,8 +406,19 @@ _braid_CommSendInit(braid_Core           core,
       _braid_CommHandleElt(handle, requests)     = requests;
       _braid_CommHandleElt(handle, status)       = status;
       _braid_CommHandleElt(handle, buffer)       = buffer;
+      _braid_CommHandleElt(handle, buffer_size)  = size;
+      _braid_CommHandleElt(handle, encoded)      = (min_size > -1);
+      _braid_CommHandleElt(handle, shm_slot)     = NULL;
+      _braid_CommHandleElt(handle, self_msg)     = NULL;
    }
 
+   if (handle != NULL)
+   {
+      _braid_CommHandleElt(handle, level) = level;
+      _braid_CommHandleElt(handle, index) = index;
+   }
+   _braid_TraceEnd(core, _braid_TRACE_SEND, level, index, ttime);
+
    *handle_ptr = handle;
 
    return _braid_error_flag;
@@ -137,29 +437,83 @@ _braid_CommWait(braid_Core          core,
    if (handle != NULL)
    {
       braid_Int      request_type = _braid_CommHandleElt(handle, request_type);
+      braid_Int      level        = _braid_CommHandleElt(handle, level);
+      braid_Int      index        = _braid_CommHandleElt(handle, index);
+      braid_Real     ttime        = 0.0;
       braid_Int      num_requests = _braid_CommHandleElt(handle, num_requests);
       MPI_Request   *requests     = _braid_CommHandleElt(handle, requests);
       MPI_Status    *status       = _braid_CommHandleElt(handle, status);
       void          *buffer       = _braid_CommHandleElt(handle, buffer);
+      void          *slot         = _braid_CommHandleElt(handle, shm_slot);
       braid_BufferStatus bstatus  = (braid_BufferStatus)core;
 
-      MPI_Waitall(num_requests, requests, status);
+      _braid_TraceBegin(core, &ttime);
+      if (_braid_CommHandleElt(handle, self_msg) != NULL)
+      {
+         /* Message to myself, move the copy left by CommSendInit */
+         braid_BaseVector  *vector_ptr = _braid_CommHandleElt(handle, vector_ptr);
+         braid_BaseVector  *self_msg   = _braid_CommHandleElt(handle, self_msg);
+
+         if (*self_msg == NULL)
+         {
+            _braid_Error(braid_ERROR_GENERIC, "Waiting on a message to myself that was never sent");
+         }
+         *vector_ptr = *self_msg;
+         *self_msg   = NULL;
+         _braid_MemMove(core, vector_ptr);
+      }
+      else if (slot != NULL)
+      {
+         /* Wait for the message in my shared-memory slot, unpack and release */
+         braid_BaseVector  *vector_ptr = _braid_CommHandleElt(handle, vector_ptr);
+
+         _braid_CommShmSpin(core, slot, 1);
+         _braid_BufferStatusInit( 0, 0, bstatus );
+         _braid_StatusElt(bstatus, send_recv_rank ) = status->MPI_SOURCE;
+         _braid_BaseBufUnpack(core, app,  _braid_ShmData(slot), vector_ptr, bstatus);
+         _braid_CommShmSetFlag(core, slot, 0);
+      }
+      else
+      {
+         MPI_Waitall(num_requests, requests, status);
+      }
       
-      if (request_type == 1) /* recv type */
+      if ( (request_type == 1) && (slot == NULL) &&
+           (_braid_CommHandleElt(handle, self_msg) == NULL) ) /* recv type */
       {
          _braid_BufferStatusInit( 0, 0, bstatus );
          braid_BaseVector  *vector_ptr = _braid_CommHandleElt(handle, vector_ptr);
          
          /* Store the sender rank the bufferStatus */   
          _braid_StatusElt(bstatus, send_recv_rank ) = status->MPI_SOURCE;
+
+         /* Decode the message into a buffer of the user's bufsize */
+         if ( _braid_CommHandleElt(handle, encoded) )
+         {
+            void      *raw;
+            braid_Int  raw_size;
+
+            _braid_BaseBufSize(core, app,  &raw_size, bstatus);
+            raw = malloc(raw_size);
+            _braid_CodecDecode(core, buffer, raw_size + _braid_CodecHeaderSize,
+                               raw, &raw_size);
+            _braid_TFree(buffer);
+            buffer = raw;
+         }
          
          _braid_BaseBufUnpack(core, app,  buffer, vector_ptr, bstatus);
       }
       
+      if (buffer != NULL)
+      {
+         _braid_MemCount(core, level, braid_MEM_COMM, -1,
+                         -_braid_CommHandleElt(handle, buffer_size));
+      }
       _braid_TFree(requests);
       _braid_TFree(status);
       _braid_TFree(handle);
       _braid_TFree(buffer);
+      _braid_TraceEnd(core, _braid_TRACE_WAIT, level, index, ttime);
 
       *handle_ptr = NULL;
    }
@@ -167,3 +521,29 @@ _braid_CommWait(braid_Core          core,
    return _braid_error_flag;
 }
 
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_CommTest(braid_Core          core,
+                _braid_CommHandle  *handle,
+                braid_Int          *flag_ptr)
+{
+   braid_Int  flag = 1;
+   braid_Int  i, done;
+
+   if (handle != NULL)
+   {
+      /* Leave the requests active, so that CommWait still gets the status */
+      for (i = 0; i < _braid_CommHandleElt(handle, num_requests); i++)
+      {
+         MPI_Request_get_status(_braid_CommHandleElt(handle, requests)[i], &done,
+                                MPI_STATUS_IGNORE);
+         flag = flag && done;
+      }
+   }
+   *flag_ptr = flag;
+
+   return _braid_error_flag;
+}
@@ -32,6 +32,8 @@ typedef struct
    braid_Int  try_refine;
    braid_Int  fmglevel;
    braid_Int  fmg_Vcyc;
+   braid_Int *nvisits;       /* number of coarse-grid corrections done on each level */
+   braid_Int  nvisits_size;
    FILE      *outfile;
 
 } _braid_CycleState;
@@ -57,6 +59,8 @@ _braid_DriveInitCycle(braid_Core          core,
    cycle.try_refine = 0;
    cycle.fmglevel   = 0;
    cycle.fmg_Vcyc   = 0;
+   cycle.nvisits_size = _braid_CoreElt(core, max_levels);
+   cycle.nvisits    = _braid_CTAlloc(braid_Int, cycle.nvisits_size);
 
    if (fmg && (nfmg != 0))
    {
@@ -100,10 +104,10 @@ _braid_DriveUpdateCycle(braid_Core          core,
    braid_Int      nfmg_Vcyc = _braid_CoreElt(core, nfmg_Vcyc);
    braid_Int      nlevels   = _braid_CoreElt(core, nlevels);
    braid_Int      io_level  = _braid_CoreElt(core, io_level);
+   braid_Int     *gammas    = _braid_CoreElt(core, gammas);
    _braid_CycleState  cycle = *cycle_ptr;
    braid_Real     rnorm;
-
-   _braid_GetRNorm(core, -1, &rnorm);
+   braid_Int      gamma, l;
 
    if (cycle.down)
    {
@@ -122,9 +126,37 @@ _braid_DriveUpdateCycle(braid_Core          core,
 
       if (level > 0)
       {
+         /* The number of levels may have grown (refinement) */
+         if (nlevels > cycle.nvisits_size)
+         {
+            cycle.nvisits = _braid_TReAlloc(cycle.nvisits, braid_Int, nlevels);
+            for (l = cycle.nvisits_size; l < nlevels; l++)
+            {
+               cycle.nvisits[l] = 0;
+            }
+            cycle.nvisits_size = nlevels;
+         }
+
+         /* Go down again until gamma coarse-grid corrections have been done on
+          * this level, e.g., twice for W-cycles.  The coarsest level is solved
+          * directly, so it is never revisited. */
+         if (level < (nlevels-1))
+         {
+            gamma = (gammas[level] > 0) ? gammas[level] : _braid_CoreElt(core, gamma_default);
+            cycle.nvisits[level]++;
+            if (cycle.nvisits[level] < gamma)
+            {
+               cycle.down = 1;
+            }
+            else
+            {
+               cycle.nvisits[level] = 0;
+            }
+         }
+
          /* If we are not on the finest grid and we are doing F-cycles, make
           * sure we do nfmg_Vcyc V-cycles at each grid level */
-         if (level < cycle.fmglevel)
+         if (!cycle.down && (level < cycle.fmglevel))
          {
             cycle.fmg_Vcyc++;
             if ( cycle.fmg_Vcyc == nfmg_Vcyc )
@@ -179,6 +211,7 @@ _braid_DriveUpdateCycle(braid_Core          core,
          tol *= rnorm0;
       }
 
+      _braid_GetRNorm(core, -1, &rnorm);
       _braid_ParFprintfFlush(cycle.outfile, myid, "%d %d %d %d %1.15e %1.15e\n",
                              level, nrefine, iter, gupper, rnorm, tol);
    }
@@ -207,6 +240,7 @@ _braid_DriveEndCycle(braid_Core          core,
    {
       fclose(cycle.outfile);
    }
+   _braid_TFree(cycle.nvisits);
 
    *cycle_ptr = cycle;
 
@@ -232,7 +266,14 @@ _braid_DriveCheckConvergence(braid_Core  core,
    braid_Optim          optim           = _braid_CoreElt(core, optim);
    braid_Int            adjoint         = _braid_CoreElt(core, adjoint);
    braid_Int            obj_only        = _braid_CoreElt(core, obj_only);
+   braid_Int            nmembers        = _braid_CoreElt(core, nmembers);
+   braid_Int           *ens_active      = _braid_CoreElt(core, ens_active);
+   braid_Int           *ens_niter       = _braid_CoreElt(core, ens_niter);
+   braid_Real          *ens_rnorm       = _braid_CoreElt(core, ens_rnorm);
+   braid_Real          *ens_rnorm0      = _braid_CoreElt(core, ens_rnorm0);
    braid_Real           rnorm, rnorm0;
+   braid_Real           mtol;
+   braid_Int            m, nleft;
    braid_Real           rnorm_adj, rnorm0_adj;
    braid_Real           tol_adj, rtol_adj;
 
@@ -276,7 +317,36 @@ _braid_DriveCheckConvergence(braid_Core  core,
       }
    }
 
-   if ( (rnorm != braid_INVALID_RNORM) && (rnorm < tol) && (tight_fine_tolx == 1) )
+   if ( (nmembers > 0) && (rnorm != braid_INVALID_RNORM) && (tight_fine_tolx == 1) )
+   {
+      /* Ensemble: converged members drop out, halt when none are left */
+      nleft = 0;
+      for (m = 0; m < nmembers; m++)
+      {
+         if (ens_active[m])
+         {
+            mtol = _braid_CoreElt(core, tol);
+            if (rtol)
+            {
+               mtol *= ens_rnorm0[m];
+            }
+            if (ens_rnorm[m] < mtol)
+            {
+               ens_active[m] = 0;
+               ens_niter[m]  = iter;
+            }
+            else
+            {
+               nleft++;
+            }
+         }
+      }
+      if (nleft == 0)
+      {
+         done = 1;
+      }
+   }
+   else if ( (rnorm != braid_INVALID_RNORM) && (rnorm < tol) && (tight_fine_tolx == 1) )
    {
       done = 1;
 
@@ -439,6 +509,7 @@ _braid_Drive(braid_Core  core,
    braid_Int            adjoint         = _braid_CoreElt(core, adjoint);
    braid_Int            seq_soln        = _braid_CoreElt(core, seq_soln);
    braid_Int            relax_only_cg   = _braid_CoreElt(core, relax_only_cg);
+   braid_Int            ckpt_interval   = _braid_CoreElt(core, ckpt_interval);
    braid_SyncStatus     sstatus         = (braid_SyncStatus)core;
 
    braid_Int     *nrels;
@@ -448,7 +519,8 @@ _braid_Drive(braid_Core  core,
 
    /* Cycle state variables */
    _braid_CycleState  cycle;
-   braid_Int          iter, level, done, refined;
+   braid_Int          iter, level, done, refined, retuned;
+   braid_Real         ttime = 0.0;
 
    /* Initialize cycle state */
    _braid_DriveInitCycle(core, &cycle);
@@ -462,16 +534,18 @@ _braid_Drive(braid_Core  core,
       done = 1;
    }
 
+   /* Continue counting from the iteration of a checkpoint, if one was read */
+   iter = _braid_CoreElt(core, ckpt_niter);
+   _braid_CoreElt(core, ckpt_niter) = 0;
+   _braid_CoreElt(core, niter) = iter;
+
    level = 0;
-   if (skip)
+   if (skip && (iter == 0))
    {
       /* Skip work on first down cycle */
       level = nlevels-1;
       _braid_CopyFineToCoarse(core);
    }
-
-   iter = 0;
-   _braid_CoreElt(core, niter) = iter;
    while (!done)
    {
       /* When there is just one grid level, do sequential time marching */
@@ -505,11 +579,15 @@ _braid_Drive(braid_Core  core,
          /* Down cycle */
 
          /* CF-relaxation */
+         _braid_TraceBegin(core, &ttime);
          _braid_FCRelax(core, level);
+         _braid_TraceEnd(core, _braid_TRACE_FCRELAX, level, -1, ttime);
 
          /* F-relax then restrict (note that FRestrict computes a new rnorm) */
          /* if adjoint: This computes the local objective function at each step on finest grid. */
+         _braid_TraceBegin(core, &ttime);
          _braid_FRestrict(core, level);
+         _braid_TraceEnd(core, _braid_TRACE_FRESTRICT, level, -1, ttime);
 
          /* Compute full residual norm if requested */
          if ( (level == 0) &&  (fullres != NULL) )
@@ -539,12 +617,15 @@ _braid_Drive(braid_Core  core,
             }
 
             /* F-relax then interpolate */
+            _braid_TraceBegin(core, &ttime);
             _braid_FInterp(core, level);
+            _braid_TraceEnd(core, _braid_TRACE_FINTERP, level, -1, ttime);
 
             level--;
          }
          else
          {
+            _braid_TraceBegin(core, &ttime);
             _braid_SyncStatusInit(iter, level, _braid_CoreElt(core, nrefine),
                                   _braid_CoreElt(core, gupper), done,
                                   braid_ASCaller_Drive_TopCycle, sstatus);
@@ -614,6 +695,29 @@ _braid_Drive(braid_Core  core,
                _braid_DriveCheckConvergence(core, iter, &done);
             }
 
+            /* Online tuning, which may rebuild the hierarchy */
+            retuned = 0;
+            if ( (_braid_CoreElt(core, tune_max) > 0) && !refined && !done )
+            {
+               _braid_AutoTune(core, &retuned);
+               nlevels    = _braid_CoreElt(core, nlevels);
+               max_levels = _braid_CoreElt(core, max_levels);
+            }
+
+            /* Outer acceleration of the cycles (the history is rebuilt after
+             * a refinement or tuning, since the C-points have changed) */
+            if ( (_braid_CoreElt(core, accel_depth) > 0) && !adjoint )
+            {
+               if (refined || retuned)
+               {
+                  _braid_AccelDestroy(core);
+               }
+               else if (!done)
+               {
+                  _braid_Accelerate(core);
+               }
+            }
+
             if ( adjoint)
             {
                /* Prepare for the next iteration */
@@ -629,11 +733,19 @@ _braid_Drive(braid_Core  core,
                _braid_TapeResetInput(core);
             }
 
+            _braid_TraceEnd(core, _braid_TRACE_CYCLETOP, 0, -1, ttime);
+
             /* Increase MGRIT iteration counter */
             if (!refined)
             {
                iter++;
                _braid_CoreElt(core, niter) = iter;
+
+               /* Write a checkpoint every ckpt_interval iterations */
+               if ( !done && (ckpt_interval > 0) && ((iter % ckpt_interval) == 0) )
+               {
+                  braid_WriteCheckpoint(core, _braid_CoreElt(core, ckpt_file));
+               }
             }
          }
       }
@@ -641,6 +753,7 @@ _braid_Drive(braid_Core  core,
 
    /* Set flag that Braid is done */
    _braid_CoreElt(core, done) = 1;
+   _braid_AccelDestroy(core);
 
    /* By default, set the final residual norm to be the same as the previous */
    {
@@ -704,6 +817,9 @@ _braid_Drive(braid_Core  core,
       _braid_TapeEvaluate(core);
    }
 
+   /* Finish a residual norm reduction still in flight */
+   _braid_RNormWait(core);
+
    /* End cycle */
    _braid_DriveEndCycle(core, &cycle);
 
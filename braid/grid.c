@@ -49,15 +49,94 @@ _braid_GridInit(braid_Core     core,
    ta = _braid_CTAlloc(braid_Real, iupper-ilower+3);
    _braid_GridElt(grid, ta_alloc) = ta;
    _braid_GridElt(grid, ta)       = ta+1;  /* shift */
+   _braid_GridElt(grid, nalloc)   = _braid_max(iupper-ilower+1, 0);
 
    /* Initialize last time step storage with NULL, only used on finest grid */
    _braid_GridElt(grid, ulast) = NULL;
+   _braid_GridElt(grid, self_msg) = NULL;
+   _braid_GridElt(grid, spill_map) = NULL;
+   _braid_GridElt(grid, pred_index)[0] = -1;
+   _braid_GridElt(grid, pred_index)[1] = -1;
 
    *grid_ptr = grid;
 
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ * Reinitialize the grid in *grid_ptr for a new index range, as if it was
+ * created with _braid_GridInit(), but keep its arrays for reuse if they are
+ * large enough.  Creates a new grid if *grid_ptr is NULL.
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_GridReset(braid_Core     core,
+                 braid_Int      level,
+                 braid_Int      ilower,
+                 braid_Int      iupper,
+                 _braid_Grid  **grid_ptr)
+{
+   _braid_Grid       *grid = *grid_ptr;
+   braid_BaseVector  *ua_alloc, *va_alloc, *fa_alloc;
+   braid_Real        *ta_alloc;
+   braid_Int          ua_nalloc, nalloc, npoints, i;
+
+   if (grid == NULL)
+   {
+      return _braid_GridInit(core, level, ilower, iupper, grid_ptr);
+   }
+
+   /* Free the vectors and any other per-grid state */
+   _braid_GridClean(core, grid);
+   _braid_SpillDestroy(core, grid);
+   _braid_UCommAsyncDestroy(core, grid);
+
+   ua_alloc  = _braid_GridElt(grid, ua_alloc);
+   ta_alloc  = _braid_GridElt(grid, ta_alloc);
+   va_alloc  = _braid_GridElt(grid, va_alloc);
+   fa_alloc  = _braid_GridElt(grid, fa_alloc);
+   ua_nalloc = _braid_GridElt(grid, ua_nalloc);
+   nalloc    = _braid_GridElt(grid, nalloc);
+
+   npoints = _braid_max(iupper-ilower+1, 0);
+   if (nalloc < npoints)
+   {
+      _braid_TFree(ta_alloc);
+      _braid_TFree(va_alloc);
+      _braid_TFree(fa_alloc);
+      ta_alloc = _braid_CTAlloc(braid_Real, npoints+2);
+      nalloc   = npoints;
+   }
+   else
+   {
+      for (i = 0; i < nalloc+2; i++)
+      {
+         ta_alloc[i] = 0.0;
+      }
+   }
+
+   memset(grid, 0, sizeof(_braid_Grid));
+   _braid_GridElt(grid, level)  = level;
+   _braid_GridElt(grid, ilower) = ilower;
+   _braid_GridElt(grid, iupper) = iupper;
+   _braid_GridElt(grid, recv_index) = _braid_RecvIndexNull;
+   _braid_GridElt(grid, send_index) = _braid_SendIndexNull;
+   _braid_GridElt(grid, pred_index)[0] = -1;
+   _braid_GridElt(grid, pred_index)[1] = -1;
+
+   /* The cleaned ua, va and fa arrays only hold NULL vectors, and are set up
+    * again in _braid_InitHierarchy() */
+   _braid_GridElt(grid, ta_alloc)  = ta_alloc;
+   _braid_GridElt(grid, ta)        = ta_alloc+1;  /* shift */
+   _braid_GridElt(grid, ua_alloc)  = ua_alloc;
+   _braid_GridElt(grid, va_alloc)  = va_alloc;
+   _braid_GridElt(grid, fa_alloc)  = fa_alloc;
+   _braid_GridElt(grid, ua_nalloc) = ua_nalloc;
+   _braid_GridElt(grid, nalloc)    = nalloc;
+
+   return _braid_error_flag;
+}
+
 /*----------------------------------------------------------------------------
  *----------------------------------------------------------------------------*/
 
@@ -111,6 +190,12 @@ _braid_GridClean(braid_Core    core,
          }
       }
    }
+   if (_braid_GridElt(grid, self_msg) != NULL)
+   {
+      _braid_BaseFree(core, app,  _braid_GridElt(grid, self_msg));
+      _braid_GridElt(grid, self_msg) = NULL;
+   }
+   _braid_PredictClean(core, grid);
 
    return _braid_error_flag;
 }
@@ -130,6 +215,8 @@ _braid_GridDestroy(braid_Core    core,
       braid_BaseVector  *fa_alloc = _braid_GridElt(grid, fa_alloc);
 
       _braid_GridClean(core, grid);
+      _braid_SpillDestroy(core, grid);
+      _braid_UCommAsyncDestroy(core, grid);
 
       if (ua_alloc)
       {
@@ -80,10 +80,13 @@ _braid_InitHierarchy(braid_Core    core,
    braid_Real       *f_ta;
    braid_Int         i, j, f_i, f_ilower, clo, chi, gclower, gcupper;
                     
-   MPI_Request       request1, request2;
-   MPI_Status        status;
-   braid_Int         left_proc, right_proc;
+   MPI_Request      *requests;
+   MPI_Status       *statuses;
+   braid_Int         nrequests, left_proc, right_proc, old_nlevels;
 
+   /* Coarse grids left from a previous hierarchy (e.g., before a refinement)
+    * are reset and reused below */
+   old_nlevels = _braid_min(nlevels, max_levels);
    grids[0] = fine_grid;
 
    /* Do sequential time marching if min_coarse is already reached */
@@ -169,8 +172,8 @@ _braid_InitHierarchy(braid_Core    core,
       if ( (gclower < gcupper) && (max_levels > level+1) &&
            ((gcupper - gclower) >= min_coarse) )
       {
-         /* Initialize the coarse grid */
-         _braid_GridInit(core, level+1, clo, chi, &grids[level+1]);
+         /* Initialize the coarse grid, reusing the old one if there is one */
+         _braid_GridReset(core, level+1, clo, chi, &grids[level+1]);
       }
       else
       {
@@ -212,7 +215,14 @@ _braid_InitHierarchy(braid_Core    core,
    nlevels = level+1;
    _braid_CoreElt(core, nlevels) = nlevels;
 
-   /* Allocate ua, va, and fa here */
+   /* Destroy old coarse grids that are not needed anymore */
+   for (level = nlevels; level < old_nlevels; level++)
+   {
+      _braid_GridDestroy(core, grids[level]);
+      grids[level] = NULL;
+   }
+
+   /* Allocate ua, va, and fa here (reset grids may still have them) */
    for (level = 0; level < nlevels; level++)
    {
       grid = grids[level];
@@ -220,8 +230,13 @@ _braid_InitHierarchy(braid_Core    core,
       iupper = _braid_GridElt(grid, iupper);
       if (level > 0)
       {
-         va = _braid_CTAlloc(braid_BaseVector, iupper-ilower+2);
-         fa = _braid_CTAlloc(braid_BaseVector, iupper-ilower+2);
+         va = _braid_GridElt(grid, va_alloc);
+         fa = _braid_GridElt(grid, fa_alloc);
+         if (va == NULL)
+         {
+            va = _braid_CTAlloc(braid_BaseVector, _braid_GridElt(grid, nalloc)+1);
+            fa = _braid_CTAlloc(braid_BaseVector, _braid_GridElt(grid, nalloc)+1);
+         }
          _braid_GridElt(grid, va_alloc) = va;
          _braid_GridElt(grid, fa_alloc) = fa;
          _braid_GridElt(grid, va)       = va+1;  /* shift */
@@ -240,13 +255,29 @@ _braid_InitHierarchy(braid_Core    core,
          nupoints = iupper-ilower+1;                  /* all points */
       }
 
-      ua = _braid_CTAlloc(braid_BaseVector, nupoints+1);
+      ua = _braid_GridElt(grid, ua_alloc);
+      if (_braid_GridElt(grid, ua_nalloc) < nupoints)
+      {
+         _braid_TFree(ua);
+      }
+      if (ua == NULL)
+      {
+         ua = _braid_CTAlloc(braid_BaseVector, nupoints+1);
+         _braid_GridElt(grid, ua_nalloc) = nupoints;
+      }
       _braid_GridElt(grid, nupoints)  = nupoints;
       _braid_GridElt(grid, ua_alloc)  = ua;
       _braid_GridElt(grid, ua)        = ua+1;  /* shift */
+
+      /* Out-of-core storage (only on level 0) */
+      _braid_SpillInit(core, grid);
    }
 
-   /* Communicate ta[-1] and ta[iupper-ilower+1] information */
+   /* Communicate ta[-1] and ta[iupper-ilower+1] information, on all levels in
+    * one nonblocking round */
+   requests  = _braid_CTAlloc(MPI_Request, 4*nlevels);
+   statuses  = _braid_CTAlloc(MPI_Status, 4*nlevels);
+   nrequests = 0;
    for (level = 0; level < nlevels; level++)
    {
       grid = grids[level];
@@ -263,7 +294,7 @@ _braid_InitHierarchy(braid_Core    core,
          if (left_proc > -1)
          {
             MPI_Irecv(&ta[-1], sizeof(braid_Real), MPI_BYTE,
-                      left_proc, 1, comm, &request1);
+                      left_proc, 1, comm, &requests[nrequests++]);
          }
          else
          {
@@ -276,7 +307,7 @@ _braid_InitHierarchy(braid_Core    core,
             if (right_proc > -1)
             {
                MPI_Irecv(&ta[iupper-ilower+1], sizeof(braid_Real), MPI_BYTE,
-                         right_proc, 1, comm, &request2);
+                         right_proc, 1, comm, &requests[nrequests++]);
             }
             else
             {
@@ -288,27 +319,24 @@ _braid_InitHierarchy(braid_Core    core,
          /* Post send that sets ta[-1] on each processor */
          if (right_proc > -1)
          {
-            MPI_Send(&ta[iupper-ilower], sizeof(braid_Real), MPI_BYTE,
-                     right_proc, 1, comm);
+            MPI_Isend(&ta[iupper-ilower], sizeof(braid_Real), MPI_BYTE,
+                      right_proc, 1, comm, &requests[nrequests++]);
          }
          /* Post send that sets ta[iupper-ilower+1] on each processor */
          if ( (left_proc > -1) && ( _braid_CoreElt(core, scoarsen) != NULL ) )
          {
-            MPI_Send(&ta[0], sizeof(braid_Real), MPI_BYTE, left_proc, 1, comm);
-         }
-
-         /* Finish receive */
-         if (left_proc > -1)
-         {
-            MPI_Wait(&request1, &status);
-         }
-         if ( (right_proc > -1) && ( _braid_CoreElt(core, scoarsen) != NULL ) )
-         {
-            MPI_Wait(&request2, &status);
+            MPI_Isend(&ta[0], sizeof(braid_Real), MPI_BYTE,
+                      left_proc, 1, comm, &requests[nrequests++]);
          }
       }
    }
 
+   /* Finish the exchanges (messages between two processors are matched in
+    * level order, since MPI does not reorder messages with the same tag) */
+   MPI_Waitall(nrequests, requests, statuses);
+   _braid_TFree(requests);
+   _braid_TFree(statuses);
+
    /* Required for Richardson.  Allocate the dtk and estimate arrays */ 
    if ( richardson || est_error )
    {
@@ -332,6 +360,8 @@ _braid_InitHierarchy(braid_Core    core,
       _braid_GetDtk(core);
    }
 
+   /* Set up shared-memory message slots for the new hierarchy */
+   _braid_CommShmInit(core);
 
    return _braid_error_flag;
 }
@@ -420,6 +450,7 @@ _braid_InitGuess(braid_Core  core,
          _braid_USetVector(core, 0, i, u, 0);    /* Store: copy u into core,
                                                     sending to left if needed */
       }
+      _braid_BaseFree(core, app,  u);
 
       _braid_UCommWait(core, 0);                 /* Wait on comm to finish */
    }
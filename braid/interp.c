@@ -53,7 +53,12 @@ _braid_FInterp(braid_Core  core,
    f_level   = level-1;
    f_cfactor = _braid_GridElt(grids[f_level], cfactor);
 
-   _braid_GetRNorm(core, -1, &rnorm);
+   /* Only get rnorm for access, it may still be reduced (see braid_SetLookahead) */
+   rnorm = braid_INVALID_RNORM;
+   if (access_level >= 3)
+   {
+      _braid_GetRNorm(core, -1, &rnorm);
+   }
    
    _braid_UCommInitF(core, level);
 
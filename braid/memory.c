@@ -0,0 +1,336 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing the vector lifetime and memory accounting.
+ *
+ *  The _braid_Base* wrappers count each braid_BaseVector from creation to free
+ *  by level and role (see braid_MEM_UA, ...).  The level and role are found
+ *  from the slot the vector is created in, i.e., the ua, va or fa array or
+ *  another field of a grid, and are updated when a vector is moved into a
+ *  grid (_braid_MemMove).  Vectors created elsewhere are temporaries on the
+ *  level of the vector they were cloned from.  Message buffers and the copies
+ *  on the adjoint tape are counted directly with _braid_MemCount.  The size of
+ *  a vector comes from the user's VectorSize routine, or else from BufSize.
+ **/
+
+#include "_braid.h"
+#include "util.h"
+
+/*----------------------------------------------------------------------------
+ * Returns the size in bytes of the user vector *u*.  Without a VectorSize
+ * routine, this is the (cached) BufSize, or zero for a shell.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_MemVectorSize(braid_Core     core,
+                     braid_Vector   u,
+                     braid_Int      shell,
+                     braid_Real    *size_ptr)
+{
+   braid_App           app     = _braid_CoreElt(core, app);
+   braid_BufferStatus  bstatus = (braid_BufferStatus)core;
+   braid_Int           messagetype, size_buffer, send_recv_rank, size;
+
+   if (_braid_CoreElt(core, vsize) != NULL)
+   {
+      _braid_CoreFcn(core, vsize)(app, u, size_ptr);
+   }
+   else if (shell)
+   {
+      *size_ptr = 0.0;
+   }
+   else
+   {
+      if (_braid_CoreElt(core, mem_vsize) < 0.0)
+      {
+         /* The buffer status may be in use by the caller, so restore it */
+         messagetype    = _braid_StatusElt(bstatus, messagetype);
+         size_buffer    = _braid_StatusElt(bstatus, size_buffer);
+         send_recv_rank = _braid_StatusElt(bstatus, send_recv_rank);
+         _braid_BufferStatusInit(0, 0, bstatus);
+         _braid_CoreFcn(core, bufsize)(app, &size, bstatus);
+         _braid_StatusElt(bstatus, messagetype)    = messagetype;
+         _braid_StatusElt(bstatus, size_buffer)    = size_buffer;
+         _braid_StatusElt(bstatus, send_recv_rank) = send_recv_rank;
+
+         _braid_CoreElt(core, mem_vsize) = (braid_Real) size;
+      }
+      *size_ptr = _braid_CoreElt(core, mem_vsize);
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Find the level and role of the vector slot *u_ptr*.  Returns -1 in
+ * *role_ptr* and leaves *level_ptr* unchanged if *u_ptr* is not part of a
+ * grid.  Slot -1 of ua and va holds the value received from the left neighbor.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_MemClassify(braid_Core         core,
+                   braid_BaseVector  *u_ptr,
+                   braid_Int         *level_ptr,
+                   braid_Int         *role_ptr)
+{
+   _braid_Grid      **grids   = _braid_CoreElt(core, grids);
+   braid_Int          nlevels = _braid_CoreElt(core, nlevels);
+   _braid_Grid       *grid;
+   braid_BaseVector  *ua_alloc, *va_alloc, *fa_alloc;
+   braid_Int          level, nalloc;
+
+   *role_ptr = -1;
+   if (grids == NULL)
+   {
+      return _braid_error_flag;
+   }
+
+   for (level = 0; level < nlevels; level++)
+   {
+      grid = grids[level];
+      if (grid == NULL)
+      {
+         continue;
+      }
+      ua_alloc = _braid_GridElt(grid, ua_alloc);
+      va_alloc = _braid_GridElt(grid, va_alloc);
+      fa_alloc = _braid_GridElt(grid, fa_alloc);
+      nalloc   = _braid_GridElt(grid, nalloc);
+
+      if ( (ua_alloc != NULL) && (u_ptr >= ua_alloc) &&
+           (u_ptr <= ua_alloc + _braid_GridElt(grid, ua_nalloc)) )
+      {
+         *role_ptr = (u_ptr == ua_alloc) ? braid_MEM_COMM : braid_MEM_UA;
+      }
+      else if ( (va_alloc != NULL) && (u_ptr >= va_alloc) && (u_ptr <= va_alloc + nalloc) )
+      {
+         *role_ptr = (u_ptr == va_alloc) ? braid_MEM_COMM : braid_MEM_VA;
+      }
+      else if ( (fa_alloc != NULL) && (u_ptr >= fa_alloc) && (u_ptr <= fa_alloc + nalloc) )
+      {
+         *role_ptr = braid_MEM_FA;
+      }
+      else if ( (char *) u_ptr >= (char *) grid && (char *) u_ptr < (char *) (grid+1) )
+      {
+         /* ulast holds the last time point in place of ua, pred_u the
+          * predictor history, and the others are received values */
+         if (u_ptr == &_braid_GridElt(grid, ulast))
+         {
+            *role_ptr = braid_MEM_UA;
+         }
+         else if ( (u_ptr == &_braid_GridElt(grid, pred_u)[0]) ||
+                   (u_ptr == &_braid_GridElt(grid, pred_u)[1]) )
+         {
+            *role_ptr = braid_MEM_TEMP;
+         }
+         else
+         {
+            *role_ptr = braid_MEM_COMM;
+         }
+      }
+
+      if (*role_ptr > -1)
+      {
+         *level_ptr = level;
+         break;
+      }
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemCount(braid_Core  core,
+                braid_Int   level,
+                braid_Int   role,
+                braid_Int   nvectors,
+                braid_Real  nbytes)
+{
+   braid_Int    mem_nlevels = _braid_CoreElt(core, mem_nlevels);
+   braid_Real  *mem_stats   = _braid_CoreElt(core, mem_stats);
+   braid_Real  *stats[3];
+   braid_Int    k;
+
+   if (mem_stats == NULL)
+   {
+      return _braid_error_flag;
+   }
+   level = _braid_max(_braid_min(level, mem_nlevels-1), 0);
+
+   /* Update the role, the level total and the overall total */
+   stats[0] = &mem_stats[_braid_MemIndex(level, role)];
+   stats[1] = &mem_stats[_braid_MemIndex(level, _braid_MEM_NROLES)];
+   stats[2] = _braid_CoreElt(core, mem_total);
+   for (k = 0; k < 3; k++)
+   {
+      stats[k][0] += (braid_Real) nvectors;
+      stats[k][1] += nbytes;
+      stats[k][2]  = _braid_max(stats[k][2], stats[k][0]);
+      stats[k][3]  = _braid_max(stats[k][3], stats[k][1]);
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemCountVector(braid_Core    core,
+                      braid_Int     level,
+                      braid_Int     role,
+                      braid_Vector  u,
+                      braid_Int     sign)
+{
+   braid_Real  size;
+
+   _braid_MemVectorSize(core, u, 0, &size);
+   _braid_MemCount(core, level, role, sign, sign*size);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemAdd(braid_Core         core,
+              braid_BaseVector   u,
+              braid_BaseVector  *u_ptr,
+              braid_Int          level,
+              braid_Int          shell)
+{
+   braid_Int   role;
+   braid_Real  size, bar_size;
+
+   _braid_MemClassify(core, u_ptr, &level, &role);
+   if (role < 0)
+   {
+      role = braid_MEM_TEMP;
+   }
+
+   _braid_MemVectorSize(core, u->userVector, shell, &size);
+   if (u->bar != NULL)
+   {
+      _braid_MemVectorSize(core, u->bar->userVector, shell, &bar_size);
+      size += bar_size;
+   }
+
+   u->mem_size  = size;
+   u->mem_level = level;
+   u->mem_role  = role;
+   _braid_MemCount(core, level, role, 1, size);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemRemove(braid_Core        core,
+                 braid_BaseVector  u)
+{
+   _braid_MemCount(core, u->mem_level, u->mem_role, -1, -(u->mem_size));
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemMove(braid_Core         core,
+               braid_BaseVector  *u_ptr)
+{
+   braid_BaseVector  u = *u_ptr;
+   braid_Int         level, role;
+
+   if (u == NULL)
+   {
+      return _braid_error_flag;
+   }
+
+   _braid_MemClassify(core, u_ptr, &level, &role);
+   if ( (role > -1) && ((level != u->mem_level) || (role != u->mem_role)) )
+   {
+      _braid_MemCount(core, u->mem_level, u->mem_role, -1, -(u->mem_size));
+      u->mem_level = level;
+      u->mem_role  = role;
+      _braid_MemCount(core, level, role, 1, u->mem_size);
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemShell(braid_Core        core,
+                braid_BaseVector  u)
+{
+   braid_Real  size;
+
+   _braid_MemVectorSize(core, u->userVector, 1, &size);
+   _braid_MemCount(core, u->mem_level, u->mem_role, 0, size - u->mem_size);
+   u->mem_size = size;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_MemReduceStats(braid_Core  core)
+{
+   MPI_Comm     comm_world  = _braid_CoreElt(core, comm_world);
+   braid_Int    mem_nlevels = _braid_CoreElt(core, mem_nlevels);
+   braid_Real  *mem_stats   = _braid_CoreElt(core, mem_stats);
+   braid_Real  *mem_gstats  = _braid_CoreElt(core, mem_gstats);
+   braid_Real  *lstats;
+   braid_Int    n, i;
+
+   /* The level statistics, followed by the totals */
+   n = _braid_MemIndex(mem_nlevels, 0);
+   lstats = _braid_TAlloc(braid_Real, n+4);
+   for (i = 0; i < n; i++)
+   {
+      lstats[i] = mem_stats[i];
+   }
+   for (i = 0; i < 4; i++)
+   {
+      lstats[n+i] = _braid_CoreElt(core, mem_total)[i];
+   }
+
+   mem_gstats = _braid_TReAlloc(mem_gstats, braid_Real, n+4);
+   MPI_Allreduce(lstats, mem_gstats, n+4, braid_MPI_REAL, MPI_MAX, comm_world);
+   _braid_CoreElt(core, mem_gstats) = mem_gstats;
+   _braid_TFree(lstats);
+
+   return _braid_error_flag;
+}
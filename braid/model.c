@@ -0,0 +1,536 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing the predictive performance model and the
+ *  configuration advisor.
+ *
+ *  The hierarchy is the one _braid_InitHierarchy() builds from the current
+ *  settings (number of time points, periodicity, min_coarse, coarsening
+ *  factors and number of relaxations), without building any grids.  With P
+ *  processors, level l has N_l points and q_l = ceil(N_l^c / P) intervals per
+ *  processor, where N_l^c is the number of C-points.  Following the cycle in
+ *  _braid_Drive(), an iteration on each level but the coarsest does
+ *
+ *     nu_l   F- and C-relaxations    (_braid_FCRelax)
+ *     1      F-relaxation and C-point residual  (_braid_FRestrict)
+ *     1      F-relaxation            (_braid_FInterp)
+ *
+ *  that is, (nu_l+2) q_l (m_l-1) + (nu_l+1) q_l steps of cost c_l each on the
+ *  critical path, and nu_l+2 messages of latency + bytes/bandwidth between
+ *  neighboring processors.  The coarsest level is one sequential sweep of N_l-1
+ *  steps, passed along by up to P-1 messages (plus nu_l relaxation sweeps if
+ *  periodic), or relaxed like the other levels with relax_only_cg.  The
+ *  residual norm adds a log2(P) latency reduction per iteration.  The number of
+ *  iterations is the number needed to reduce the residual by the tolerance
+ *  with a constant convergence factor rho.  The sequential time is N_0-1 steps
+ *  of cost c_0.  Vector operations and user routines other than Step are not
+ *  modeled, so they should be included in the step costs if significant.
+ **/
+
+#include <math.h>
+#include "_braid.h"
+#include "util.h"
+
+/*----------------------------------------------------------------------------
+ * Number of levels, points, coarsening factors and relaxations of the
+ * hierarchy _braid_InitHierarchy() builds with at most 'max_levels' levels.
+ * Settings beyond the core's max_levels are the defaults.  If 'cfactor' or
+ * 'nrelax' are nonnegative, they are used on all levels instead.  The arrays
+ * must hold 'max_levels' entries.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_ModelHierarchy(braid_Core   core,
+                      braid_Int    max_levels,
+                      braid_Int    cfactor,
+                      braid_Int    nrelax,
+                      braid_Int   *nlevels_ptr,
+                      braid_Int   *npoints,
+                      braid_Int   *cfactors,
+                      braid_Int   *nrelaxs)
+{
+   braid_Int   core_levels = _braid_CoreElt(core, max_levels);
+   braid_Int   min_coarse  = _braid_CoreElt(core, min_coarse);
+   braid_Int   gupper      = _braid_CoreElt(core, gupper);
+   braid_Int   level, gclower, gcupper;
+
+   if (gupper <= min_coarse)
+   {
+      max_levels = 1;
+   }
+
+   gclower = 0;
+   gcupper = gupper;
+   for (level = 0; level < max_levels; level++)
+   {
+      npoints[level] = gcupper + 1;
+      if (level < core_levels)
+      {
+         _braid_GetCFactor(core, level, &cfactors[level]);
+         nrelaxs[level] = _braid_CoreElt(core, nrels)[level];
+      }
+      else
+      {
+         cfactors[level] = _braid_CoreElt(core, cfdefault);
+         nrelaxs[level]  = -1;
+      }
+      if (nrelaxs[level] < 0)
+      {
+         nrelaxs[level] = _braid_CoreElt(core, nrdefault);
+      }
+      if (cfactor > 0)
+      {
+         cfactors[level] = cfactor;
+      }
+      if (nrelax > -1)
+      {
+         nrelaxs[level] = nrelax;
+      }
+
+      _braid_ProjectInterval(gclower, gcupper, 0, cfactors[level], &gclower, &gcupper);
+      _braid_MapFineToCoarse(gclower, cfactors[level], gclower);
+      _braid_MapFineToCoarse(gcupper, cfactors[level], gcupper);
+      if ( !( (gclower < gcupper) && (max_levels > level+1) &&
+              ((gcupper - gclower) >= min_coarse) ) )
+      {
+         break;
+      }
+   }
+   *nlevels_ptr = _braid_min(level+1, max_levels);
+
+   /* The drive loop relaxes the periodic coarsest level with the settings of
+    * the core's coarsest level */
+   level = *nlevels_ptr - 1;
+   if ( (level > 0) && _braid_CoreElt(core, periodic) && (nrelax < 0) )
+   {
+      nrelaxs[level] = _braid_CoreElt(core, nrels)[core_levels-1];
+      if (nrelaxs[level] < 0)
+      {
+         nrelaxs[level] = _braid_CoreElt(core, nrdefault);
+      }
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Predicted wall time of one iteration on 'nprocs' processors, see the model
+ * at the top of this file.  'msg' is the time of one message.
+ *----------------------------------------------------------------------------*/
+
+static braid_Real
+_braid_ModelIterTime(braid_Core   core,
+                     braid_Int    nprocs,
+                     braid_Int    nlevels,
+                     braid_Int   *npoints,
+                     braid_Int   *cfactors,
+                     braid_Int   *nrelaxs,
+                     braid_Real  *costs,
+                     braid_Real   latency,
+                     braid_Real   msg)
+{
+   braid_Int   relax_only_cg = _braid_CoreElt(core, relax_only_cg);
+   braid_Int   level, m, nu, nc, q, nsweeps;
+   braid_Real  titer, pmsg;
+
+   pmsg  = (nprocs > 1) ? msg : 0.0;
+   titer = 0.0;
+   for (level = 0; level < nlevels; level++)
+   {
+      m  = cfactors[level];
+      nu = nrelaxs[level];
+      nc = (npoints[level] - 1) / m + 1;
+      q  = (nc + nprocs - 1) / nprocs;
+      if (level < nlevels-1)
+      {
+         titer += ( (nu+2)*q*(m-1) + (nu+1)*q ) * costs[level];
+         titer += (nu+2) * pmsg;
+      }
+      else if ( (nlevels > 1) && relax_only_cg )
+      {
+         /* Relaxation only: nu CF-relaxations and the F-relaxation of FInterp */
+         titer += ( (nu+1)*q*(m-1) + nu*q ) * costs[level];
+         titer += (nu+1) * pmsg;
+      }
+      else
+      {
+         /* Sequential sweeps, passed along the processors */
+         nsweeps = (_braid_CoreElt(core, periodic) && (nlevels > 1)) ? nu+1 : 1;
+         titer += nsweeps * (npoints[level] - 1) * costs[level];
+         titer += nsweeps * (_braid_min(nprocs, npoints[level]) - 1) * msg;
+      }
+   }
+
+   /* Residual norm reduction */
+   if (nprocs > 1)
+   {
+      titer += ceil(log((braid_Real) nprocs) / log(2.0)) * latency;
+   }
+
+   return titer;
+}
+
+/*----------------------------------------------------------------------------
+ * Set up the model inputs: the step cost on each of 'max_levels' levels, the
+ * time of one message, the convergence factor, and the residual reduction to
+ * reach the tolerance.  Missing step costs are the measured ones (see
+ * braid_SetAutoTune) or, beyond these, the cost of the last given level.  A
+ * nonpositive conv_factor is replaced by the average convergence factor of the
+ * last braid_Drive().  On failure, *rho_ptr* is set to zero.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_ModelSetup(braid_Core    core,
+                  braid_Int     max_levels,
+                  braid_Int     ncosts,
+                  braid_Real   *step_costs,
+                  braid_Real    latency,
+                  braid_Real    bandwidth,
+                  braid_Real    conv_factor,
+                  braid_Real   *costs,
+                  braid_Real   *msg_ptr,
+                  braid_Real   *rho_ptr,
+                  braid_Real   *reduction_ptr)
+{
+   braid_App           app         = _braid_CoreElt(core, app);
+   braid_BufferStatus  bstatus     = (braid_BufferStatus)core;
+   braid_Real         *tune_gstats = _braid_CoreElt(core, tune_gstats);
+   braid_Real         *step_gstats = _braid_CoreElt(core, step_gstats);
+   braid_Real         *rnorms      = _braid_CoreElt(core, rnorms);
+   braid_Int           niter       = _braid_CoreElt(core, niter);
+   braid_Real          tol         = _braid_CoreElt(core, tol);
+   braid_Int           level, size, i, ifirst, ilast;
+   braid_Real          rnorm0;
+
+   *rho_ptr = 0.0;
+
+   /* Step costs */
+   if ( (ncosts < 1) || (step_costs == NULL) )
+   {
+      ncosts = 0;
+      if ( (tune_gstats != NULL) && (step_gstats != NULL) )
+      {
+         for (level = 0; level < _braid_CoreElt(core, nlevels); level++)
+         {
+            if (step_gstats[3*level+2] <= 0.0)
+            {
+               break;
+            }
+            costs[level] = tune_gstats[3*level] / step_gstats[3*level+2];
+            ncosts++;
+         }
+      }
+      if (ncosts == 0)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "No step costs given or measured\n");
+         return _braid_error_flag;
+      }
+   }
+   else
+   {
+      for (level = 0; level < _braid_min(ncosts, max_levels); level++)
+      {
+         costs[level] = step_costs[level];
+      }
+   }
+   for (level = ncosts; level < max_levels; level++)
+   {
+      costs[level] = costs[ncosts-1];
+   }
+
+   /* Message time, with the size of a buffer */
+   _braid_BufferStatusInit(0, 0, bstatus);
+   _braid_CoreFcn(core, bufsize)(app, &size, bstatus);
+   *msg_ptr = latency;
+   if (bandwidth > 0.0)
+   {
+      *msg_ptr += size / bandwidth;
+   }
+
+   /* Convergence factor, from the first and last valid residual norms */
+   if (conv_factor <= 0.0)
+   {
+      ifirst = -1;
+      ilast  = -1;
+      if (rnorms != NULL)
+      {
+         for (i = 0; i <= niter; i++)
+         {
+            if (rnorms[i] > 0.0)
+            {
+               if (ifirst < 0)
+               {
+                  ifirst = i;
+               }
+               ilast = i;
+            }
+         }
+      }
+      if (ilast <= ifirst)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "No convergence factor given or measured\n");
+         return _braid_error_flag;
+      }
+      conv_factor = pow(rnorms[ilast] / rnorms[ifirst], 1.0 / (ilast - ifirst));
+   }
+
+   /* An absolute tolerance is relative to the last initial residual, if any */
+   *reduction_ptr = tol;
+   rnorm0 = _braid_CoreElt(core, rnorm0);
+   if ( !_braid_CoreElt(core, rtol) && (rnorm0 > 0.0) )
+   {
+      *reduction_ptr = tol / rnorm0;
+   }
+   *rho_ptr = conv_factor;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Predicted number of iterations, or max_iter+1 if the tolerance is not
+ * reached within max_iter iterations
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_ModelNIter(braid_Core  core,
+                  braid_Int   nlevels,
+                  braid_Real  rho,
+                  braid_Real  reduction)
+{
+   braid_Int   max_iter = _braid_CoreElt(core, max_iter);
+   braid_Real  niter;
+
+   /* Sequential time stepping is exact after one pass */
+   if ( (nlevels == 1) || (reduction >= 1.0) )
+   {
+      return 1;
+   }
+   if (rho >= 1.0)
+   {
+      return max_iter+1;
+   }
+   niter = ceil(log(reduction) / log(rho));
+
+   return (braid_Int) _braid_max(_braid_min(niter, max_iter+1), 1.0);
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+braid_PredictTime(braid_Core   core,
+                  braid_Int    nprocs,
+                  braid_Int    ncosts,
+                  braid_Real  *step_costs,
+                  braid_Real   latency,
+                  braid_Real   bandwidth,
+                  braid_Real   conv_factor,
+                  braid_Real  *time_ptr,
+                  braid_Real  *speedup_ptr,
+                  braid_Int   *niter_ptr)
+{
+   braid_Int    max_levels = _braid_CoreElt(core, max_levels);
+   braid_Int   *npoints, *cfactors, *nrelaxs;
+   braid_Int    nlevels, niter;
+   braid_Real  *costs, msg, rho, reduction, time, tseq;
+
+   npoints  = _braid_CTAlloc(braid_Int, max_levels);
+   cfactors = _braid_CTAlloc(braid_Int, max_levels);
+   nrelaxs  = _braid_CTAlloc(braid_Int, max_levels);
+   costs    = _braid_CTAlloc(braid_Real, max_levels);
+
+   *time_ptr    = -1.0;
+   *speedup_ptr = 0.0;
+   *niter_ptr   = 0;
+   _braid_ModelSetup(core, max_levels, ncosts, step_costs, latency, bandwidth,
+                     conv_factor, costs, &msg, &rho, &reduction);
+   if (rho > 0.0)
+   {
+      _braid_ModelHierarchy(core, max_levels, -1, -1, &nlevels, npoints, cfactors, nrelaxs);
+      niter = _braid_ModelNIter(core, nlevels, rho, reduction);
+      time  = niter * _braid_ModelIterTime(core, _braid_max(nprocs, 1), nlevels, npoints,
+                                           cfactors, nrelaxs, costs, latency, msg);
+      tseq  = (npoints[0] - 1) * costs[0];
+
+      *time_ptr    = time;
+      *speedup_ptr = (time > 0.0) ? tseq / time : 0.0;
+      *niter_ptr   = niter;
+   }
+
+   _braid_TFree(npoints);
+   _braid_TFree(cfactors);
+   _braid_TFree(nrelaxs);
+   _braid_TFree(costs);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * The candidates are the processor counts 1, 2, 4, ... and max_nprocs, times
+ * the numbers of levels the hierarchy can have.  The coarsening factors and
+ * relaxations are the current ones, since the convergence factor is only
+ * known for these.
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+braid_AdviseConfig(braid_Core   core,
+                   braid_Int    max_nprocs,
+                   braid_Int    ncosts,
+                   braid_Real  *step_costs,
+                   braid_Real   latency,
+                   braid_Real   bandwidth,
+                   braid_Real   conv_factor,
+                   braid_Int    nbest)
+{
+   braid_Int    myid     = _braid_CoreElt(core, myid_world);
+   braid_Int    max_iter = _braid_CoreElt(core, max_iter);
+   braid_Int   *npoints, *cfactors, *nrelaxs;
+   braid_Int   *cand_nprocs, *cand_levels, *cand_niter, *order;
+   braid_Real  *costs, *cand_time;
+   braid_Real   msg, rho, reduction, tseq, titer;
+   braid_Int    max_levels, nlevels, ml, nl, np, ncand, niter, i, j, k;
+
+   /* The deepest hierarchy with the current settings bounds the candidates */
+   max_levels = 1;
+   for (nl = _braid_CoreElt(core, gupper); nl > 1; nl = (nl-1)/2 + 1)
+   {
+      max_levels++;
+   }
+   max_nprocs = _braid_max(max_nprocs, 1);
+
+   npoints  = _braid_CTAlloc(braid_Int, max_levels);
+   cfactors = _braid_CTAlloc(braid_Int, max_levels);
+   nrelaxs  = _braid_CTAlloc(braid_Int, max_levels);
+   costs    = _braid_CTAlloc(braid_Real, max_levels);
+
+   _braid_ModelSetup(core, max_levels, ncosts, step_costs, latency, bandwidth,
+                     conv_factor, costs, &msg, &rho, &reduction);
+   if (rho <= 0.0)
+   {
+      _braid_TFree(npoints);
+      _braid_TFree(cfactors);
+      _braid_TFree(nrelaxs);
+      _braid_TFree(costs);
+      return _braid_error_flag;
+   }
+
+   ncand = max_levels * (2 + (braid_Int) (log((braid_Real) max_nprocs) / log(2.0)));
+   cand_nprocs = _braid_CTAlloc(braid_Int, ncand);
+   cand_levels = _braid_CTAlloc(braid_Int, ncand);
+   cand_niter  = _braid_CTAlloc(braid_Int, ncand);
+   cand_time   = _braid_CTAlloc(braid_Real, ncand);
+   order       = _braid_CTAlloc(braid_Int, ncand);
+
+   /* Evaluate each distinct hierarchy on each processor count */
+   ncand = 0;
+   tseq  = 0.0;
+   for (ml = 1; ml <= max_levels; ml++)
+   {
+      _braid_ModelHierarchy(core, ml, -1, -1, &nlevels, npoints, cfactors, nrelaxs);
+      if (nlevels < ml)
+      {
+         break;
+      }
+      tseq  = (npoints[0] - 1) * costs[0];
+      niter = _braid_ModelNIter(core, nlevels, rho, reduction);
+      for (np = 1; ; np = _braid_min(2*np, max_nprocs))
+      {
+         titer = _braid_ModelIterTime(core, np, nlevels, npoints, cfactors, nrelaxs,
+                                      costs, latency, msg);
+         cand_nprocs[ncand] = np;
+         cand_levels[ncand] = nlevels;
+         cand_niter[ncand]  = niter;
+         cand_time[ncand]   = niter * titer;
+         ncand++;
+         if (np == max_nprocs)
+         {
+            break;
+         }
+      }
+   }
+
+   /* Rank by predicted time (insertion sort), unconverged runs last */
+   for (i = 0; i < ncand; i++)
+   {
+      for (j = i; j > 0; j--)
+      {
+         k = order[j-1];
+         if ( (cand_niter[k] <= max_iter) &&
+              ( (cand_niter[i] > max_iter) || (cand_time[k] <= cand_time[i]) ) )
+         {
+            break;
+         }
+         order[j] = k;
+      }
+      order[j] = i;
+   }
+
+   if (myid == 0)
+   {
+      _braid_printf("\n  Predicted time to solution for ntime = %d, convergence factor %1.2e,\n"
+                    "  step cost %1.2e s, message time %1.2e s\n\n",
+                    _braid_CoreElt(core, ntime), rho, costs[0], msg);
+      _braid_printf("  rank  nprocs  nlevels  iters     time (s)   speedup  efficiency\n");
+      _braid_printf("  ----------------------------------------------------------------\n");
+      for (i = 0; i < _braid_min(nbest, ncand); i++)
+      {
+         k = order[i];
+         if (cand_niter[k] > max_iter)
+         {
+            _braid_printf("  %4d  %6d  %7d  %5s  %11s\n", i+1, cand_nprocs[k], cand_levels[k],
+                          "-", "no conv.");
+         }
+         else
+         {
+            _braid_printf("  %4d  %6d  %7d  %5d  %11.3e  %8.2f  %10.2f\n", i+1, cand_nprocs[k],
+                          cand_levels[k], cand_niter[k], cand_time[k], tseq / cand_time[k],
+                          tseq / (cand_time[k] * cand_nprocs[k]));
+         }
+      }
+      if (ncand > 0)
+      {
+         k = order[0];
+         _braid_ModelHierarchy(core, cand_levels[k], -1, -1, &nlevels, npoints, cfactors, nrelaxs);
+         _braid_printf("\n  Best: %d processors, braid_SetMaxLevels(core, %d), levels (points, cfactor, nrelax):\n",
+                       cand_nprocs[k], nlevels);
+         for (i = 0; i < nlevels; i++)
+         {
+            _braid_printf("   %3d  (%d, %d, %d)\n", i, npoints[i],
+                          (i < nlevels-1) ? cfactors[i] : 0, nrelaxs[i]);
+         }
+         _braid_printf("\n");
+      }
+   }
+
+   _braid_TFree(npoints);
+   _braid_TFree(cfactors);
+   _braid_TFree(nrelaxs);
+   _braid_TFree(costs);
+   _braid_TFree(cand_nprocs);
+   _braid_TFree(cand_levels);
+   _braid_TFree(cand_niter);
+   _braid_TFree(cand_time);
+   _braid_TFree(order);
+
+   return _braid_error_flag;
+}
@@ -18,6 +18,8 @@
 
 #ifdef braid_SEQUENTIAL
 
+#include <sys/time.h>
+
 MPI_Comm
 MPI_Comm_f2c( int comm )
 {
@@ -53,13 +55,17 @@ MPI_Abort( MPI_Comm comm,
 double
 MPI_Wtime( )
 {
-   return(0.0);
+   struct timeval tv;
+
+   /* Wall-clock time, so that timings also work without MPI */
+   gettimeofday(&tv, NULL);
+   return( (double) tv.tv_sec + 1.0e-6 * (double) tv.tv_usec );
 }
 
 double
 MPI_Wtick( )
 {
-   return(0.0);
+   return(1.0e-6);
 }
 
 int
@@ -452,6 +458,15 @@ MPI_Testall( int          count,
    return(0);
 }
 
+int
+MPI_Request_get_status( MPI_Request  request,
+                        int         *flag,
+                        MPI_Status  *status )
+{
+   *flag = 1;
+   return(0);
+}
+
 int
 MPI_Wait( MPI_Request *request,
                 MPI_Status  *status )
@@ -631,4 +646,73 @@ MPI_Op_free( MPI_Op *op )
    return(0);
 }
 
+/* File I/O with stdio.  Only byte counts (MPI_BYTE) are supported, and
+ * opening with MPI_MODE_CREATE truncates the file. */
+
+int
+MPI_File_open( MPI_Comm    comm,
+               const char *filename,
+               int         amode,
+               MPI_Info    info,
+               MPI_File   *fh )
+{
+   FILE *fp;
+
+   if (amode & MPI_MODE_CREATE)
+   {
+      fp = fopen(filename, "w+b");
+   }
+   else
+   {
+      fp = fopen(filename, "rb");
+   }
+   *fh = (MPI_File) fp;
+
+   return (fp == NULL);
+}
+
+int
+MPI_File_close( MPI_File *fh )
+{
+   fclose((FILE *) *fh);
+   *fh = NULL;
+
+   return(0);
+}
+
+int
+MPI_File_set_size( MPI_File    fh,
+                   MPI_Offset  size )
+{
+   return(0);
+}
+
+int
+MPI_File_write_at( MPI_File      fh,
+                   MPI_Offset    offset,
+                   void         *buf,
+                   int           count,
+                   MPI_Datatype  datatype,
+                   MPI_Status   *status )
+{
+   fseek((FILE *) fh, offset, SEEK_SET);
+   fwrite(buf, 1, count, (FILE *) fh);
+
+   return(0);
+}
+
+int
+MPI_File_read_at( MPI_File      fh,
+                  MPI_Offset    offset,
+                  void         *buf,
+                  int           count,
+                  MPI_Datatype  datatype,
+                  MPI_Status   *status )
+{
+   fseek((FILE *) fh, offset, SEEK_SET);
+   fread(buf, 1, count, (FILE *) fh);
+
+   return(0);
+}
+
 #endif
@@ -39,9 +39,19 @@ typedef struct
 } MPI_Status;
 typedef int  MPI_Op;
 typedef int  MPI_Aint;
+typedef int  MPI_Win;
+typedef void *MPI_File;
+typedef long  MPI_Offset;
+typedef int   MPI_Info;
 
 #define  MPI_COMM_WORLD 0
 #define  MPI_COMM_NULL  -1
+#define  MPI_WIN_NULL   -1
+#define  MPI_INFO_NULL  0
+
+#define  MPI_MODE_CREATE 1
+#define  MPI_MODE_RDONLY 2
+#define  MPI_MODE_WRONLY 4
 
 #define  MPI_BOTTOM  0x0
 
@@ -110,6 +120,7 @@ int MPI_Probe( int source , int tag , MPI_Comm comm , MPI_Status *status );
 int MPI_Iprobe( int source , int tag , MPI_Comm comm , int *flag , MPI_Status *status );
 int MPI_Test( MPI_Request *request , int *flag , MPI_Status *status );
 int MPI_Testall( int count , MPI_Request *array_of_requests , int *flag , MPI_Status *array_of_statuses );
+int MPI_Request_get_status( MPI_Request request , int *flag , MPI_Status *status );
 int MPI_Wait( MPI_Request *request , MPI_Status *status );
 int MPI_Waitall( int count , MPI_Request *array_of_requests , MPI_Status *array_of_statuses );
 int MPI_Waitany( int count , MPI_Request *array_of_requests , int *index , MPI_Status *status );
@@ -123,6 +134,11 @@ int MPI_Type_hvector( int count , int blocklength , MPI_Aint stride , MPI_Dataty
 int MPI_Type_struct( int count , int *array_of_blocklengths , MPI_Aint *array_of_displacements , MPI_Datatype *array_of_types , MPI_Datatype *newtype );
 int MPI_Type_commit( MPI_Datatype *datatype );
 int MPI_Type_free( MPI_Datatype *datatype );
+int MPI_File_open( MPI_Comm comm , const char *filename , int amode , MPI_Info info , MPI_File *fh );
+int MPI_File_close( MPI_File *fh );
+int MPI_File_set_size( MPI_File fh , MPI_Offset size );
+int MPI_File_write_at( MPI_File fh , MPI_Offset offset , void *buf , int count , MPI_Datatype datatype , MPI_Status *status );
+int MPI_File_read_at( MPI_File fh , MPI_Offset offset , void *buf , int count , MPI_Datatype datatype , MPI_Status *status );
 
 #endif
    
@@ -74,6 +74,9 @@ _braid_GetRNorm(braid_Core  core,
    braid_Int    max_iter = _braid_CoreElt(core, max_iter);
    braid_Int    k;
 
+   /* Finish a pending reduction */
+   _braid_RNormWait(core);
+
    /* Initialize to invalid value */
    *rnorm_ptr = braid_INVALID_RNORM;
 
@@ -91,6 +94,78 @@ _braid_GetRNorm(braid_Core  core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ * Start the global reduction of the local residual norm contribution.  With
+ * lookahead, the down-cycle continues to the coarse grids while the reduction
+ * is in flight, and it is only completed when the norm is first needed (at the
+ * latest, for the convergence check at the end of the cycle).  Since every
+ * processor starts the reduction before its coarse-grid work, waiting for it
+ * then is typically free, and no global synchronization is left between the
+ * end of one iteration and the start of the next.
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_RNormStart(braid_Core  core,
+                  braid_Real  rnorm)
+{
+   MPI_Comm     comm  = _braid_CoreElt(core, comm);
+   braid_Int    tnorm = _braid_CoreElt(core, tnorm);
+   MPI_Op       op;
+
+   _braid_RNormWait(core);
+
+   op = (tnorm == 3) ? MPI_MAX : MPI_SUM;
+   _braid_CoreElt(core, rnorm_lbuf)    = rnorm;
+   _braid_CoreElt(core, rnorm_iter)    = _braid_CoreElt(core, niter);
+   _braid_CoreElt(core, rnorm_request) = MPI_REQUEST_NULL;
+
+#if !defined(braid_SEQUENTIAL) && defined(MPI_VERSION) && (MPI_VERSION >= 3)
+   if (_braid_CoreElt(core, lookahead))
+   {
+      MPI_Iallreduce(&_braid_CoreElt(core, rnorm_lbuf), &_braid_CoreElt(core, rnorm_gbuf),
+                     1, braid_MPI_REAL, op, comm, &_braid_CoreElt(core, rnorm_request));
+      return _braid_error_flag;
+   }
+#endif
+
+   MPI_Allreduce(&_braid_CoreElt(core, rnorm_lbuf), &_braid_CoreElt(core, rnorm_gbuf),
+                 1, braid_MPI_REAL, op, comm);
+   _braid_RNormWait(core);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_RNormWait(braid_Core  core)
+{
+   braid_Int    tnorm = _braid_CoreElt(core, tnorm);
+   braid_Int    iter  = _braid_CoreElt(core, rnorm_iter);
+   braid_Real   grnorm;
+
+   if (iter < 0)
+   {
+      return _braid_error_flag;
+   }
+
+   if (_braid_CoreElt(core, rnorm_request) != MPI_REQUEST_NULL)
+   {
+      MPI_Wait(&_braid_CoreElt(core, rnorm_request), MPI_STATUS_IGNORE);
+   }
+   grnorm = _braid_CoreElt(core, rnorm_gbuf);
+   if ((tnorm != 1) && (tnorm != 3))
+   {
+      grnorm = sqrt(grnorm);          /* two-norm */
+   }
+
+   _braid_CoreElt(core, rnorm_iter) = -1;
+   _braid_SetRNorm(core, iter, grnorm);
+
+   return _braid_error_flag;
+}
+
 /*----------------------------------------------------------------------------
  * Same as SetRNorm, but sets full residual norm
  *----------------------------------------------------------------------------*/
@@ -299,6 +374,107 @@ _braid_ComputeFullRNorm(braid_Core  core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_EnsembleSpatialNorm(braid_Core        core,
+                           braid_BaseVector  r,
+                           braid_Real       *rnorm_ptr)
+{
+   braid_App    app        = _braid_CoreElt(core, app);
+   braid_Int    tnorm      = _braid_CoreElt(core, tnorm);
+   braid_Int    nmembers   = _braid_CoreElt(core, nmembers);
+   braid_Int   *ens_active = _braid_CoreElt(core, ens_active);
+   braid_Real  *ens_lnorm  = _braid_CoreElt(core, ens_lnorm);
+   braid_Real  *ens_snorm  = _braid_CoreElt(core, ens_snorm);
+   braid_Real   rnorm = 0.0;
+   braid_Int    m;
+
+   _braid_BaseEnsembleNorm(core, app, r, ens_snorm);
+
+   for (m = 0; m < nmembers; m++)
+   {
+      if(tnorm == 1)       /* one-norm */ 
+      {  
+         ens_lnorm[m] += ens_snorm[m];
+      }
+      else if(tnorm == 3)  /* inf-norm */
+      {  
+         ens_lnorm[m] = _braid_max(ens_lnorm[m], ens_snorm[m]);
+      }
+      else                 /* default two-norm */
+      {  
+         ens_lnorm[m] += (ens_snorm[m]*ens_snorm[m]);
+      }
+
+      if (ens_active[m])
+      {
+         rnorm = _braid_max(rnorm, ens_snorm[m]);
+      }
+   }
+
+   *rnorm_ptr = rnorm;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_EnsembleRNorm(braid_Core   core,
+                     braid_Real  *rnorm_ptr)
+{
+   MPI_Comm     comm       = _braid_CoreElt(core, comm);
+   braid_Int    tnorm      = _braid_CoreElt(core, tnorm);
+   braid_Int    nmembers   = _braid_CoreElt(core, nmembers);
+   braid_Int   *ens_active = _braid_CoreElt(core, ens_active);
+   braid_Real  *ens_rnorm  = _braid_CoreElt(core, ens_rnorm);
+   braid_Real  *ens_rnorm0 = _braid_CoreElt(core, ens_rnorm0);
+   braid_Real  *ens_lnorm  = _braid_CoreElt(core, ens_lnorm);
+   braid_Real  *ens_snorm  = _braid_CoreElt(core, ens_snorm);
+   braid_Real   rnorm = 0.0;
+   braid_Int    m;
+
+   /* One reduction for all members (ens_snorm is free for use as scratch) */
+   if(tnorm == 3)       /* inf-norm reduction */
+   {  
+      MPI_Allreduce(ens_lnorm, ens_snorm, nmembers, braid_MPI_REAL, MPI_MAX, comm);
+   }
+   else                 /* one-norm and two-norm reductions */
+   {  
+      MPI_Allreduce(ens_lnorm, ens_snorm, nmembers, braid_MPI_REAL, MPI_SUM, comm);
+   }
+
+   for (m = 0; m < nmembers; m++)
+   {
+      ens_lnorm[m] = 0.0;
+
+      /* Converged members keep the norm they converged with */
+      if (ens_active[m])
+      {
+         ens_rnorm[m] = ens_snorm[m];
+         if ((tnorm != 1) && (tnorm != 3))
+         {
+            ens_rnorm[m] = sqrt(ens_rnorm[m]);
+         }
+
+         /* Set initial residual norm if not already set */
+         if (ens_rnorm0[m] == braid_INVALID_RNORM)
+         {
+            ens_rnorm0[m] = ens_rnorm[m];
+         }
+
+         rnorm = _braid_max(rnorm, ens_rnorm[m]);
+      }
+   }
+
+   *rnorm_ptr = rnorm;
+
+   return _braid_error_flag;
+}
+
 /*----------------------------------------------------------------------------
  * Print the residual norm at ever C-point for debugging purposes 
  *----------------------------------------------------------------------------*/
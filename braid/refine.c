@@ -257,19 +257,21 @@ _braid_FRefine(braid_Core   core,
    braid_Int         npoints, ilower, iupper, gupper, i, j, ii;
    braid_Int         r_npoints, r_ilower, r_iupper, r_i, r_ii;
    braid_Int         f_npoints, f_ilower, f_iupper, f_gupper, f_i, f_j, f_ii;
-   braid_Int        *r_ca, *r_fa, *f_ca, f_first, f_next, next;
+   braid_Int        *r_ca, *r_fa, *f_ca, f_first, f_next, f_nextproc, next;
    braid_Real       *ta, *r_ta_alloc, *r_ta, *f_ta;
 
    braid_BaseVector *send_ua, *recv_ua, u;
    braid_Int        *send_procs, *recv_procs, *send_unums, *recv_unums, *iptr;
-   braid_Int        *send_iis,   *recv_f_iis;
+   braid_Int        *send_iis,   *recv_f_iis, *recv_sizes, *r_bounds;
+   braid_Int        *next_procs, *next_msgs, nnexts, r_first, wlo;
    braid_Real       *send_buffer, *recv_buffer, **send_buffers, **recv_buffers, *bptr;
-   void             *buffer;
+   void             *buffer, *raw;
    braid_Int         send_size, recv_size, *send_sizes, size, isize, max_usize;
-   braid_Int         ncomms, nsends, nrecvs, nreceived, nprocs, myproc, proc, prevproc;
+   braid_Int         min_size, raw_size;
+   braid_Int         ncomms, nsends, nrecvs, nprocs, myproc, proc, prevproc;
    braid_Int         unum, send_msg, recv_msg;
-   MPI_Request      *requests, request;
-   MPI_Status       *statuses, status;
+   MPI_Request      *requests;
+   MPI_Status       *statuses;
                    
    _braid_Grid      *f_grid;
    braid_Int         cfactor, rfactor, m, interval, flo, fhi, fi, ci, f_hi, f_ci;
@@ -436,7 +438,8 @@ _braid_FRefine(braid_Core   core,
       /* Post r_ta receive */
       if ((iupper < gupper) || periodic)
       {
-         MPI_Irecv(&r_ta[r_npoints], 1, braid_MPI_REAL, MPI_ANY_SOURCE, 2, comm,
+         _braid_GetBlockDistProc((gupper+1), nprocs, (iupper+1), periodic, &proc);
+         MPI_Irecv(&r_ta[r_npoints], 1, braid_MPI_REAL, proc, 2, comm,
                    &requests[ncomms++]);
       }
 
@@ -454,60 +457,88 @@ _braid_FRefine(braid_Core   core,
    /*-----------------------------------------------------------------------*/
    /* 3. Send the index mapping and time value information (r_ca, r_ta) to the
     * appropriate processors to build index mapping and time value information
-    * for the fine grid (f_ca, f_ta).  Also compute f_first and f_next. */
+    * for the fine grid (f_ca, f_ta).  Also compute f_first and f_next.
+    *
+    * The refined intervals of all processors are gathered first, so that each
+    * processor knows exactly which processors it receives from and how much.
+    * All messages are then posted at once, one per destination.  The f_next
+    * value comes from the processor owning the fine index f_iupper+1. */
+
+   r_bounds = _braid_TAlloc(braid_Int, 2*nprocs);
+   {
+      braid_Int  inbuf[2];
+
+      inbuf[0] = r_ilower;
+      inbuf[1] = r_iupper;
+      MPI_Allgather(inbuf, 2, braid_MPI_INT, r_bounds, 2, braid_MPI_INT, comm);
+   }
 
-   /* Post f_next receive */
+   /* Compute receive information */
    f_next = -1;
+   f_nextproc = -1;
    if (f_npoints > 0)
    {
       f_next = f_gupper+1;
-      if (f_iupper < f_gupper)
+   }
+   nrecvs = _braid_min(nprocs, f_npoints);
+   recv_procs = _braid_CTAlloc(braid_Int, nrecvs);
+   recv_sizes = _braid_CTAlloc(braid_Int, nrecvs);
+   nrecvs = 0;
+   for (proc = 0; (proc < nprocs) && (f_npoints > 0); proc++)
+   {
+      braid_Int  lo = r_bounds[2*proc], hi = r_bounds[2*proc+1];
+
+      /* Refined indexes can be negative in the periodic case, and these are
+       * mapped to the end of the fine grid as [wlo, f_gupper] */
+      wlo = f_gupper+1;
+      if (lo < 0)
+      {
+         wlo = lo + (f_gupper+1);
+         lo  = 0;
+      }
+      size  = _braid_max(_braid_min(hi, f_iupper) - _braid_max(lo, f_ilower) + 1, 0);
+      size += _braid_max(f_iupper - _braid_max(wlo, f_ilower) + 1, 0);
+      if (size > 0)
+      {
+         recv_procs[nrecvs] = proc;
+         recv_sizes[nrecvs] = size;
+         nrecvs++;
+      }
+
+      /* Check for the owner of the next fine index */
+      next = f_iupper+1;
+      if ( (next <= f_gupper) && (((next >= lo) && (next <= hi)) || (next >= wlo)) )
       {
-         MPI_Irecv(&f_next, 1, braid_MPI_INT, MPI_ANY_SOURCE, 3, comm, &request);
+         f_nextproc = proc;
       }
    }
+   _braid_TFree(r_bounds);
 
-   /* Compute send information and send f_next info */
+   /* Compute send information.  In the periodic case, the negative refined
+    * indexes are visited last so that the destination processors increase. */
    size = 2*sizeof(braid_Int);         /* size of two integers */
    _braid_NBytesToNReals(size, isize); /* convert to units of braid_Real */
    send_procs  = _braid_CTAlloc(braid_Int,  r_npoints);
    send_sizes  = _braid_CTAlloc(braid_Int,  r_npoints);
-   send_buffer = _braid_CTAlloc(braid_Real, r_npoints*(1+isize+1));
+   send_buffer = _braid_CTAlloc(braid_Real, r_npoints*(isize+1));
+   next_procs  = _braid_CTAlloc(braid_Int,  r_npoints);
+   next_msgs   = _braid_CTAlloc(braid_Int,  r_npoints);
+   r_first = _braid_min(_braid_max(-r_ilower, 0), r_npoints);
+   nsends = 0;
+   nnexts = 0;
    bptr = send_buffer;
-   nsends = -1;
-   _braid_GetBlockDistProc((f_gupper+1), nprocs, (r_ilower-1), periodic, &prevproc);
    ii = 0;
-   for (r_ii = 0; r_ii < r_npoints; r_ii++)
+   for (m = 0; m < r_npoints; m++)
    {
-      r_i = r_ilower + r_ii;
+      r_ii = (r_first + m) % r_npoints;
+      r_i  = r_ilower + r_ii;
       _braid_GetBlockDistProc((f_gupper+1), nprocs, r_i, periodic, &proc);
-      if ((proc != prevproc) || (nsends < 0))
+      if ((nsends == 0) || (proc != send_procs[nsends-1]))
       {
-         nsends++;
          send_procs[nsends] = proc;
-         bptr++; /* leave room for size value */
-
-         if ((proc != prevproc) && (prevproc > -1))
-         {
-            braid_Int  msg;
-
-            /* Send f_next info */
-            if (r_i < 0)
-            {
-               /* Refined indexes can be negative in the periodic case.  Want to
-                * send an upper bound for the positive periodic value of these
-                * indexes (not zero). */
-               msg = (f_gupper+1);
-            }
-            else
-            {
-               msg = r_fa[ii];
-            }
-            MPI_Send(&msg, 1, braid_MPI_INT, prevproc, 3, comm);
-         }
-         prevproc = proc;
+         nsends++;
       }
-      send_sizes[nsends] += (isize+1);
+      send_sizes[nsends-1] += (isize+1);
 
       iptr = (braid_Int *) bptr;
       iptr[0] = r_i;
@@ -517,12 +548,35 @@ _braid_FRefine(braid_Core   core,
       bptr++;
 
       /* Update f_next info */
-      if (r_fa[ii] == r_i)
+      if (r_i >= 0)
       {
-         ii++;
+         while (r_fa[ii] < r_i)
+         {
+            ii++;
+         }
+      }
+
+      /* If r_i is the first index of a fine interval, send f_next info to the
+       * processor on the left */
+      f_i = r_i;
+      if (periodic)
+      {
+         _braid_MapPeriodic(f_i, (f_gupper+1));
+      }
+      if (f_i > 0)
+      {
+         _braid_GetBlockDistProc((f_gupper+1), nprocs, (f_i-1), periodic, &prevproc);
+         if (prevproc != proc)
+         {
+            /* Refined indexes can be negative in the periodic case.  Want to
+             * send an upper bound for the positive periodic value of these
+             * indexes (not zero). */
+            next_procs[nnexts] = prevproc;
+            next_msgs[nnexts]  = (r_i < 0) ? (f_gupper+1) : r_fa[ii];
+            nnexts++;
+         }
       }
    }
-   nsends++;
 
 #if DEBUG
    for (m = 0; m < nsends; m++)
@@ -534,68 +588,66 @@ _braid_FRefine(braid_Core   core,
    }
 #endif
 
-   requests = _braid_CTAlloc(MPI_Request, nsends);
-   statuses = _braid_CTAlloc(MPI_Status,  nsends);
+   ncomms = nrecvs + 1 + nsends + nnexts; /* Upper bound */
+   requests = _braid_CTAlloc(MPI_Request, ncomms);
+   statuses = _braid_CTAlloc(MPI_Status,  ncomms);
+   ncomms = 0;
+
+   /* Post receives */
+   recv_buffer = _braid_CTAlloc(braid_Real, f_npoints*(isize+1));
+   bptr = recv_buffer;
+   for (m = 0; m < nrecvs; m++)
+   {
+      size = recv_sizes[m]*(isize+1);
+      MPI_Irecv(bptr, size, braid_MPI_REAL, recv_procs[m], 4, comm,
+                &requests[ncomms++]);
+      bptr += size;
+   }
+   if (f_nextproc > -1)
+   {
+      MPI_Irecv(&f_next, 1, braid_MPI_INT, f_nextproc, 3, comm, &requests[ncomms++]);
+   }
 
-   /* Post sends (do this first, since we will poll on receives) */
+   /* Post sends */
    bptr = send_buffer;
    for (m = 0; m < nsends; m++)
    {
       size = send_sizes[m];
-      proc = send_procs[m];
-      bptr[0] = (braid_Real) size; /* insert size at the beginning */
-      MPI_Isend(bptr, (1+size), braid_MPI_REAL, proc, 4, comm, &requests[m]);
-      bptr += (1+size);
+      MPI_Isend(bptr, size, braid_MPI_REAL, send_procs[m], 4, comm,
+                &requests[ncomms++]);
+      bptr += size;
+   }
+   for (m = 0; m < nnexts; m++)
+   {
+      MPI_Isend(&next_msgs[m], 1, braid_MPI_INT, next_procs[m], 3, comm,
+                &requests[ncomms++]);
    }
 
-   /* Post receives */
-   recv_size = f_npoints*(1+isize+1); /* max receive size */
-   recv_buffer = _braid_CTAlloc(braid_Real, recv_size);
+   MPI_Waitall(ncomms, requests, statuses);
+
+   /* Unpack receives */
    f_ca = _braid_CTAlloc(braid_Int,  f_npoints);
    f_ta = _braid_GridElt(f_grid, ta);
-   nreceived = 0;
-   while (nreceived < f_npoints)
+   bptr = recv_buffer;
+   for (j = 0; j < f_npoints; j++)
    {
-      /* post receive from arbitrary process (should always get at least one) */
-      bptr = recv_buffer;
-      size = recv_size;
-      MPI_Recv(bptr, size, braid_MPI_REAL, MPI_ANY_SOURCE, 4, comm, &status);
-
-      size = (braid_Int) bptr[0];
-      bptr++;
-      for (j = 0; j < size; j += (isize+1))
+      iptr = (braid_Int *) bptr;
+      f_i = iptr[0];
+      /* Since this is being used as an array index, ensure that it is has
+       * the correct positive value in the periodic case */
+      if (periodic)
       {
-         iptr = (braid_Int *) bptr;
-         f_i = iptr[0];
-         /* Since this is being used as an array index, ensure that it is has
-          * the correct positive value in the periodic case */
-         if (periodic)
-         {
-            _braid_MapPeriodic(f_i, (f_gupper+1));
-         }
-         f_ii = f_i - f_ilower;
-         f_ca[f_ii] = iptr[1];
-         bptr += isize;
-         f_ta[f_ii] = bptr[0];
-         bptr++;
-         {
+         _braid_MapPeriodic(f_i, (f_gupper+1));
+      }
+      f_ii = f_i - f_ilower;
+      f_ca[f_ii] = iptr[1];
+      bptr += isize;
+      f_ta[f_ii] = bptr[0];
+      bptr++;
 #if DEBUG
-            printf("%d %d: 1 f_i = %02d, f_ca = %2d, f_ta = %f  (recv %2d) \n",
-                   FRefine_count, myproc, f_i, f_ca[f_ii], f_ta[f_ii], nreceived);
+      printf("%d %d: 1 f_i = %02d, f_ca = %2d, f_ta = %f\n",
+             FRefine_count, myproc, f_i, f_ca[f_ii], f_ta[f_ii]);
 #endif
-         }
-         nreceived++;
-      }
-   }
-
-   /* Finish sends and f_next receive */
-   MPI_Waitall(nsends, requests, statuses);
-   if (f_npoints > 0)
-   {
-      if (f_iupper < f_gupper)
-      {
-         MPI_Wait(&request, &status);
-      }
    }
 
    /* Compute f_first */
@@ -617,9 +669,13 @@ _braid_FRefine(braid_Core   core,
    /* Free up some memory */
    _braid_TFree(requests);
    _braid_TFree(statuses);
+   _braid_TFree(recv_procs);
+   _braid_TFree(recv_sizes);
    _braid_TFree(send_procs);
    _braid_TFree(send_sizes);
    _braid_TFree(send_buffer);
+   _braid_TFree(next_procs);
+   _braid_TFree(next_msgs);
    _braid_TFree(recv_buffer);
 
    /*-----------------------------------------------------------------------*/
@@ -773,6 +829,16 @@ _braid_FRefine(braid_Core   core,
 
    _braid_BufferStatusInit( 1, 0, bstatus );
    _braid_BaseBufSize(core, app,  &max_usize, bstatus); /* max buffer size */
+
+   /* If messages go through the codec layer, vectors are packed into raw and
+    * then encoded into the message buffer */
+   raw = NULL;
+   _braid_CodecGetMinSize(core, 0, &min_size);
+   if (min_size > -1)
+   {
+      raw = malloc(max_usize);
+      _braid_CodecBufSize(core, 0, &max_usize);
+   }
    _braid_NBytesToNReals(max_usize, max_usize);
 
    /* Post u-vector receives */
@@ -808,8 +874,17 @@ _braid_FRefine(braid_Core   core,
             buffer = &bptr[1];
             _braid_BaseBufSize(core, app,  &size, bstatus);
             _braid_StatusElt( bstatus, size_buffer ) = size;
-            _braid_BaseBufPack(core, app,  send_ua[ii], buffer, bstatus);
-            size = _braid_StatusElt(bstatus, size_buffer);
+            if (min_size > -1)
+            {
+               _braid_BaseBufPack(core, app,  send_ua[ii], raw, bstatus);
+               size = _braid_StatusElt(bstatus, size_buffer);
+               _braid_CodecEncode(core, 0, raw, size, buffer, &size);
+            }
+            else
+            {
+               _braid_BaseBufPack(core, app,  send_ua[ii], buffer, bstatus);
+               size = _braid_StatusElt(bstatus, size_buffer);
+            }
             _braid_BaseFree(core, app,  send_ua[ii]);
             _braid_NBytesToNReals(size, size);
             bptr[0] = (braid_Int) size; /* insert size at the beginning */
@@ -854,8 +929,13 @@ _braid_FRefine(braid_Core   core,
          {
             /* Unpack buffer into u-vector */
             buffer = &bptr[1];
-            _braid_BaseBufUnpack(core, app, buffer, &recv_ua[f_ii], bstatus);
             size = (braid_Int) bptr[0];
+            if (min_size > -1)
+            {
+               _braid_CodecDecode(core, buffer, size*sizeof(braid_Real), raw, &raw_size);
+               buffer = raw;
+            }
+            _braid_BaseBufUnpack(core, app, buffer, &recv_ua[f_ii], bstatus);
             bptr += (1+size);
             unum--;
          }
@@ -874,6 +954,10 @@ _braid_FRefine(braid_Core   core,
    }
 
    /* Free up some memory */
+   if (raw != NULL)
+   {
+      _braid_TFree(raw);
+   }
    _braid_TFree(send_ua);
    _braid_TFree(send_procs);
    _braid_TFree(send_unums);
@@ -913,9 +997,12 @@ _braid_FRefine(braid_Core   core,
          _braid_TFree(_braid_CoreElt(core, dtk));
       }
 
-      for (level = 0; level < nlevels; level++)
+      /* Keep the coarse grids, _braid_InitHierarchy() resets and reuses them */
+      _braid_GridDestroy(core, grids[0]);
+      grids[0] = NULL;
+      for (level = 1; level < nlevels; level++)
       {
-         _braid_GridDestroy(core, grids[level]);
+         _braid_GridClean(core, grids[level]);
       }
    }
 
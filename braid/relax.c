@@ -46,6 +46,7 @@ _braid_FCRelax(braid_Core  core,
    braid_Int            iter         = _braid_CoreElt(core, niter);
    braid_Int            nrefine      = _braid_CoreElt(core, nrefine);
    braid_Int            gupper_zero  = _braid_CoreElt(core, gupper);
+   braid_Int            async;
 
    braid_BaseVector  u, u_old;
    braid_Real        CWt;
@@ -88,6 +89,10 @@ _braid_FCRelax(braid_Core  core,
    nrelax  = nrels[level];
    CWt     = CWts[level];
 
+   /* Asynchronous relaxation, not on the coarsest level (sequential solve) */
+   async = ( (_braid_CoreElt(core, async_stale) > 0) && !done && (level < nlevels-1) &&
+             !richardson && !_braid_CoreElt(core, adjoint) );
+
    for (nu = 0; nu < nrelax; nu++)
    {
       _braid_UCommInit(core, level);
@@ -118,6 +123,7 @@ _braid_FCRelax(braid_Core  core,
            
             braid_Int iu, is_stored;
             _braid_UGetIndex(core, level, cupper, &iu, &is_stored);
+            _braid_SpillFetch(core, level, iu);
             _braid_BaseBufPack(core, app,  ua[iu], send_buff, bstatus);
 
             size = _braid_StatusElt( bstatus, size_buffer );
@@ -133,11 +139,25 @@ _braid_FCRelax(braid_Core  core,
 
          if (flo <= fhi)
          {
-            _braid_UGetVector(core, level, flo-1, &u);
+            if (async)
+            {
+               _braid_UGetVectorAsync(core, level, flo-1, &u);
+            }
+            else
+            {
+               _braid_UGetVector(core, level, flo-1, &u);
+            }
          }
          else if (ci > _braid_CoreElt(core, initiali))
          {
-            _braid_UGetVector(core, level, ci-1, &u);
+            if (async)
+            {
+               _braid_UGetVectorAsync(core, level, ci-1, &u);
+            }
+            else
+            {
+               _braid_UGetVector(core, level, ci-1, &u);
+            }
          }
 
          /* For Richardson, now receive the C-point in left-most interval */
@@ -159,14 +179,19 @@ _braid_FCRelax(braid_Core  core,
                /* We own the solution at previous coarse grid point, so clone it */
                 braid_Int iu, is_stored;
                _braid_UGetIndex(core, level, ci - cfactor , &iu, &is_stored);
+               _braid_SpillFetch(core, level, iu);
 
                _braid_BaseClone(core, app, ua[iu], &bigstep );
                time_left = ta[ci-cfactor-ilower];
             }
          }
 
-         /* F-relaxation */
-         _braid_GetRNorm(core, -1, &rnm);
+         /* F-relaxation (only get rnm for access, it may still be reduced) */
+         rnm = braid_INVALID_RNORM;
+         if ( (access_level >= 3) || (done == 1) )
+         {
+            _braid_GetRNorm(core, -1, &rnm);
+         }
          for (fi = flo; fi <= fhi; fi++)
          {
             _braid_Step(core, level, fi, NULL, u);
@@ -228,6 +253,7 @@ _braid_FCRelax(braid_Core  core,
 
                _braid_BaseClone(core, app, bigstep, &ua[iu]);
                _braid_BaseFree(core, app,  bigstep);
+               _braid_SpillUpdate(core, level, iu);
             }
 
             /* Allow user to process current vector */
@@ -67,7 +67,6 @@ braid_Int
 _braid_FRestrict(braid_Core   core,
                  braid_Int    level)
 {
-   MPI_Comm              comm         = _braid_CoreElt(core, comm);
    braid_App             app          = _braid_CoreElt(core, app);
    _braid_Grid         **grids        = _braid_CoreElt(core, grids);
    braid_AccessStatus    astatus      = (braid_AccessStatus)core;
@@ -77,6 +76,7 @@ _braid_FRestrict(braid_Core   core,
    braid_Int             access_level = _braid_CoreElt(core, access_level);
    braid_Int             tnorm        = _braid_CoreElt(core, tnorm);
    braid_Real           *tnorm_a      = _braid_CoreElt(core, tnorm_a);
+   braid_Int             nmembers     = _braid_CoreElt(core, nmembers);
    braid_Int             nrefine      = _braid_CoreElt(core, nrefine);
    braid_Int             gupper       = _braid_CoreElt(core, gupper);
    braid_Int             cfactor      = _braid_GridElt(grids[level], cfactor);
@@ -130,8 +130,12 @@ _braid_FRestrict(braid_Core   core,
          _braid_UGetVector(core, level, ci-1, &r);
       }
 
-      /* F-relaxation */
-      _braid_GetRNorm(core, -1, &rnm);
+      /* F-relaxation (only get rnm for access, it may still be reduced) */
+      rnm = braid_INVALID_RNORM;
+      if (access_level >= 3)
+      {
+         _braid_GetRNorm(core, -1, &rnm);
+      }
       for (fi = flo; fi <= fhi; fi++)
       {
          _braid_Step(core, level, fi, NULL, r);
@@ -183,7 +187,14 @@ _braid_FRestrict(braid_Core   core,
          /* Compute rnorm (only on level 0). Richardson computes the rnorm later */
          if (level == 0 && !richardson )
          {
-            _braid_BaseSpatialNorm(core, app,  r, &rnorm_temp);
+            if (nmembers > 0)
+            {
+               _braid_EnsembleSpatialNorm(core, r, &rnorm_temp);
+            }
+            else
+            {
+               _braid_BaseSpatialNorm(core, app,  r, &rnorm_temp);
+            }
             tnorm_a[interval] = rnorm_temp;       /* inf-norm uses tnorm_a */
             if(tnorm == 1) 
             {  
@@ -257,7 +268,14 @@ _braid_FRestrict(braid_Core   core,
 
                /* Compute the rnorm */
                _braid_BaseSum(core, app, 1.0, c_fa[c_ii], -1.0, c_u );
-               _braid_BaseSpatialNorm(core, app, c_u, &rnorm_temp);
+               if (nmembers > 0)
+               {
+                  _braid_EnsembleSpatialNorm(core, c_u, &rnorm_temp);
+               }
+               else
+               {
+                  _braid_BaseSpatialNorm(core, app, c_u, &rnorm_temp);
+               }
                
                tnorm_a[c_ii] = rnorm_temp;       /* inf-norm uses tnorm_a */
                if(tnorm == 1) 
@@ -306,23 +324,24 @@ _braid_FRestrict(braid_Core   core,
    /* Compute global rnorm (only on level 0) */
    if (level == 0)
    {
-      if(tnorm == 1)          /* one-norm reduction */
-      {  
-         MPI_Allreduce(&rnorm, &grnorm, 1, braid_MPI_REAL, MPI_SUM, comm);
-      }
-      else if(tnorm == 3)     /* inf-norm reduction */
-      {  
-         _braid_Max(tnorm_a, ncpoints, &rnorm); 
-         MPI_Allreduce(&rnorm, &grnorm, 1, braid_MPI_REAL, MPI_MAX, comm);
-      }
-      else                    /* default two-norm reduction */
-      {  
-         MPI_Allreduce(&rnorm, &grnorm, 1, braid_MPI_REAL, MPI_SUM, comm);
-         grnorm = sqrt(grnorm);
+      if (nmembers > 0)       /* per-member reduction */
+      {
+         _braid_EnsembleRNorm(core, &grnorm);
+
+         /* Store new rnorm */
+         _braid_SetRNorm(core, -1, grnorm);
       }
+      else
+      {
+         if(tnorm == 3)       /* inf-norm reduction */
+         {  
+            _braid_Max(tnorm_a, ncpoints, &rnorm); 
+         }
 
-      /* Store new rnorm */
-      _braid_SetRNorm(core, -1, grnorm);
+         /* One-norm, inf-norm or default two-norm reduction, which also stores
+          * the new rnorm (possibly later, see braid_SetLookahead) */
+         _braid_RNormStart(core, rnorm);
+      }
    }
    
    /* If debug printing, print out tnorm_a for this interval. This
@@ -46,7 +46,9 @@ _braid_Coarsen(braid_Core        core,
 
    braid_Int      c_ii = c_index-c_ilower;
    braid_Int      f_ii = f_index-f_ilower;
-   
+   braid_Real     ttime = 0.0;
+
+   _braid_TraceBegin(core, &ttime);
    if ( _braid_CoreElt(core, scoarsen) == NULL )
    {
       /* No spatial coarsening needed, just clone the fine vector.*/
@@ -60,6 +62,8 @@ _braid_Coarsen(braid_Core        core,
                                   level-1, nrefine, gupper, c_index, cstatus);
       _braid_BaseSCoarsen(core, app, fvector, cvector, cstatus);
    }
+   _braid_TraceEnd(core, _braid_TRACE_COARSEN, level, c_index, ttime);
+
    return _braid_error_flag;
 }
 
@@ -80,7 +84,9 @@ _braid_RefineBasic(braid_Core        core,
    braid_CoarsenRefStatus cstatus = (braid_CoarsenRefStatus)core;
    braid_Int              nrefine = _braid_CoreElt(core, nrefine);
    braid_Int              gupper  = _braid_CoreElt(core, gupper);
+   braid_Real             ttime   = 0.0;
 
+   _braid_TraceBegin(core, &ttime);
    if ( _braid_CoreElt(core, scoarsen) == NULL )
    {
       /* No spatial refinement needed, just clone the fine vector.*/
@@ -93,6 +99,7 @@ _braid_RefineBasic(braid_Core        core,
                                   level, nrefine, gupper, c_index, cstatus);
       _braid_BaseSRefine(core,  app, cvector, fvector, cstatus);
    }
+   _braid_TraceEnd(core, _braid_TRACE_REFINE, level, c_index, ttime);
 
    return _braid_error_flag;
 }
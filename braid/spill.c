@@ -0,0 +1,467 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing out-of-core and compressed storage of the
+ *  fine-grid u-vectors.
+ *
+ *  At most 'spill' u-vectors of ua on level 0 are kept in memory.  When more
+ *  are stored, cold vectors are chosen with the clock (second-chance)
+ *  algorithm, packed with bufpack, and freed.  The packed vector goes either
+ *
+ *     - to its slot in a memory-mapped (and unlinked) scratch file with one
+ *       slot of BufSize bytes per entry of ua (out-of-core storage), or
+ *     - through the codec layer into a malloc'd buffer of just the compressed
+ *       size (compressed storage, see codec.c).
+ *
+ *  A spilled vector is unpacked again the next time it is accessed through
+ *  the uvector.c routines.  In out-of-core storage, the slots next to a vector
+ *  that is read back are prefetched, since the cycle sweeps over ua in order
+ *  (left to right in restriction and right to left in relaxation).  The last
+ *  u-vector (the one sent to the right neighbor) is never spilled.
+ *
+ *  The spill state of each entry of ua is
+ *     0 : untracked (empty, or a shell)
+ *     1 : resident in memory
+ *     2 : spilled
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "_braid.h"
+#include "util.h"
+
+#define _braid_SpillUntracked  0
+#define _braid_SpillResident   1
+#define _braid_SpillSpilled    2
+
+/*----------------------------------------------------------------------------
+ * Ask the kernel to start reading slot 'iu' of the spill file, if it holds a
+ * spilled vector.  This returns immediately, so the read overlaps with work.
+ *----------------------------------------------------------------------------*/
+
+static void
+_braid_SpillPrefetch(_braid_Grid  *grid,
+                     braid_Int     iu)
+{
+   char       *spill_state = _braid_GridElt(grid, spill_state);
+   size_t      slotsize    = (size_t) _braid_GridElt(grid, spill_slotsize);
+   size_t      pagesize    = (size_t) sysconf(_SC_PAGESIZE);
+   char       *slot;
+   size_t      offset;
+
+   if ((_braid_GridElt(grid, spill_map) != NULL) &&
+       (iu >= 0) && (iu < _braid_GridElt(grid, nupoints)) &&
+       (spill_state[iu] == _braid_SpillSpilled))
+   {
+      /* madvise() needs a page-aligned address */
+      slot   = _braid_GridElt(grid, spill_map) + iu*slotsize;
+      offset = ((size_t) slot) % pagesize;
+      madvise(slot - offset, slotsize + offset, MADV_WILLNEED);
+   }
+}
+
+/*----------------------------------------------------------------------------
+ * Free the compressed copy of u-vector 'iu', if any
+ *----------------------------------------------------------------------------*/
+
+static void
+_braid_SpillDiscard(_braid_Grid  *grid,
+                    braid_Int     iu)
+{
+   void  **spill_data = _braid_GridElt(grid, spill_data);
+
+   if ((spill_data != NULL) && (spill_data[iu] != NULL))
+   {
+      _braid_GridElt(grid, spill_bytes) -= (braid_Real) _braid_GridElt(grid, spill_sizes)[iu];
+      _braid_TFree(spill_data[iu]);
+   }
+}
+
+/*----------------------------------------------------------------------------
+ * Pack u-vector 'iu' to its slot of the spill file or to a compressed copy,
+ * and free it
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_SpillWrite(braid_Core    core,
+                  _braid_Grid  *grid,
+                  braid_Int     iu)
+{
+   braid_App           app     = _braid_CoreElt(core, app);
+   braid_BufferStatus  bstatus = (braid_BufferStatus)core;
+   braid_BaseVector   *ua      = _braid_GridElt(grid, ua);
+   void               *buffer  = _braid_GridElt(grid, spill_buffer);
+   void              **spill_data;
+   braid_Int           size;
+   char               *cbuffer;
+
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   if (_braid_GridElt(grid, spill_map) != NULL)
+   {
+      _braid_BaseBufPack(core, app,  ua[iu],
+                         _braid_GridElt(grid, spill_map) + (size_t)iu*_braid_GridElt(grid, spill_slotsize),
+                         bstatus);
+   }
+   else
+   {
+      /* Pack to the scratch buffer, compress behind it, and keep just the
+       * compressed bytes */
+      spill_data = _braid_GridElt(grid, spill_data);
+      _braid_BaseBufPack(core, app,  ua[iu], buffer, bstatus);
+      size    = _braid_StatusElt(bstatus, size_buffer);
+      cbuffer = (char *) buffer + _braid_GridElt(grid, spill_bufsize);
+      _braid_CodecCompress(core, buffer, size, cbuffer, &size);
+      spill_data[iu] = _braid_TAlloc(char, size);
+      memcpy(spill_data[iu], cbuffer, size);
+      _braid_GridElt(grid, spill_sizes)[iu] = size;
+      _braid_GridElt(grid, spill_bytes)    += (braid_Real) size;
+   }
+   _braid_BaseFree(core, app,  ua[iu]);
+   ua[iu] = NULL;
+   _braid_CoreElt(core, spill_stats)[0] += 1;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Unpack spilled u-vector 'iu' from the spill file or its compressed copy
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_SpillRead(braid_Core    core,
+                 _braid_Grid  *grid,
+                 braid_Int     iu)
+{
+   braid_App           app     = _braid_CoreElt(core, app);
+   braid_BufferStatus  bstatus = (braid_BufferStatus)core;
+   braid_BaseVector   *ua      = _braid_GridElt(grid, ua);
+   void               *buffer  = _braid_GridElt(grid, spill_buffer);
+   braid_Int           size;
+
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   if (_braid_GridElt(grid, spill_map) != NULL)
+   {
+      _braid_BaseBufUnpack(core, app,
+                           _braid_GridElt(grid, spill_map) + (size_t)iu*_braid_GridElt(grid, spill_slotsize),
+                           &ua[iu], bstatus);
+
+      /* Start reading the vectors that the sweep needs next */
+      _braid_SpillPrefetch(grid, iu-1);
+      _braid_SpillPrefetch(grid, iu+1);
+   }
+   else
+   {
+      _braid_CodecDecode(core, _braid_GridElt(grid, spill_data)[iu],
+                         _braid_GridElt(grid, spill_sizes)[iu], buffer, &size);
+      _braid_BaseBufUnpack(core, app, buffer, &ua[iu], bstatus);
+      _braid_SpillDiscard(grid, iu);
+   }
+   _braid_CoreElt(core, spill_stats)[1] += 1;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Mark u-vector 'iu' as recently used, and spill cold u-vectors until no more
+ * than 'spill' are resident.  Vector 'iu' and the last vector are never
+ * spilled here.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_SpillTouch(braid_Core    core,
+                  _braid_Grid  *grid,
+                  braid_Int     iu)
+{
+   braid_Int           spill       = _braid_CoreElt(core, spill);
+   braid_BaseVector   *ua          = _braid_GridElt(grid, ua);
+   braid_Int           nupoints    = _braid_GridElt(grid, nupoints);
+   char               *spill_state = _braid_GridElt(grid, spill_state);
+   char               *spill_ref   = _braid_GridElt(grid, spill_ref);
+   braid_Int           hand        = _braid_GridElt(grid, spill_hand);
+   braid_Int           nresident   = _braid_GridElt(grid, spill_nresident);
+
+   /* Room for 'iu' and the last vector */
+   if (spill < 2)
+   {
+      spill = 2;
+   }
+
+   if (ua[iu] != NULL)
+   {
+      if (spill_state[iu] != _braid_SpillResident)
+      {
+         nresident++;
+      }
+      spill_state[iu] = _braid_SpillResident;
+      spill_ref[iu]   = 1;
+   }
+   else if (spill_state[iu] == _braid_SpillResident)
+   {
+      spill_state[iu] = _braid_SpillUntracked;
+      nresident--;
+   }
+
+   while (nresident > spill)
+   {
+      if ((hand != iu) && (hand != nupoints-1) &&
+          (spill_state[hand] == _braid_SpillResident))
+      {
+         if (ua[hand] == NULL)
+         {
+            /* The vector was removed from ua behind our back */
+            spill_state[hand] = _braid_SpillUntracked;
+            nresident--;
+         }
+         else if (spill_ref[hand])
+         {
+            /* Give it a second chance */
+            spill_ref[hand] = 0;
+         }
+         else
+         {
+            _braid_SpillWrite(core, grid, hand);
+            spill_state[hand] = _braid_SpillSpilled;
+            nresident--;
+         }
+      }
+      hand = (hand+1) % nupoints;
+   }
+
+   _braid_GridElt(grid, spill_hand)      = hand;
+   _braid_GridElt(grid, spill_nresident) = nresident;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_SpillInit(braid_Core    core,
+                 _braid_Grid  *grid)
+{
+   braid_App           app      = _braid_CoreElt(core, app);
+   char               *dir      = _braid_CoreElt(core, spill_dir);
+   braid_Int           nupoints = _braid_GridElt(grid, nupoints);
+   braid_BufferStatus  bstatus  = (braid_BufferStatus)core;
+   braid_Int           size, slotsize, fd;
+   size_t              mapsize;
+   char               *map, filename[1024];
+
+   _braid_GridElt(grid, spill_state) = NULL;
+   _braid_GridElt(grid, spill_map)   = NULL;
+   _braid_GridElt(grid, spill_data)  = NULL;
+
+   if ( (_braid_CoreElt(core, spill) < 1) || (_braid_GridElt(grid, level) != 0) ||
+        (nupoints <= _braid_CoreElt(core, spill)) )
+   {
+      /* Everything fits in memory */
+      return _braid_error_flag;
+   }
+
+   _braid_BufferStatusInit( 0, 0, bstatus );
+   _braid_BaseBufSize(core, app,  &size, bstatus);
+
+   if (_braid_CoreElt(core, spill_compress))
+   {
+      /* Scratch space for a packed vector followed by its compressed copy */
+      _braid_GridElt(grid, spill_data)   = _braid_CTAlloc(void *, nupoints);
+      _braid_GridElt(grid, spill_sizes)  = _braid_CTAlloc(braid_Int, nupoints);
+      _braid_GridElt(grid, spill_buffer) = _braid_TAlloc(char, 2*size + _braid_CodecHeaderSize);
+      _braid_GridElt(grid, spill_bytes)  = 0.0;
+   }
+   else
+   {
+      if (dir == NULL)
+      {
+         dir = getenv("TMPDIR");
+      }
+      if (dir == NULL)
+      {
+         dir = ".";
+      }
+
+      /* One slot per u-vector, rounded up so that slots stay aligned */
+      slotsize = ((size + 63) / 64) * 64;
+      mapsize  = (size_t) nupoints * slotsize;
+
+      /* The file is unlinked right away, so it disappears when it is unmapped,
+       * even if the run is aborted */
+      snprintf(filename, sizeof(filename), "%s/braid_spill.%d.%d", dir,
+               (int) getpid(), (int) _braid_CoreElt(core, myid_world));
+      fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0600);
+      if (fd < 0)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "Cannot create out-of-core spill file");
+         return _braid_error_flag;
+      }
+      unlink(filename);
+      if (ftruncate(fd, (off_t) mapsize) != 0)
+      {
+         close(fd);
+         _braid_Error(braid_ERROR_GENERIC, "Cannot resize out-of-core spill file");
+         return _braid_error_flag;
+      }
+      map = mmap(NULL, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if (map == MAP_FAILED)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "Cannot map out-of-core spill file");
+         return _braid_error_flag;
+      }
+
+      _braid_GridElt(grid, spill_map)      = map;
+      _braid_GridElt(grid, spill_slotsize) = slotsize;
+   }
+
+   _braid_GridElt(grid, spill_bufsize)   = size;
+   _braid_GridElt(grid, spill_state)     = _braid_CTAlloc(char, nupoints);
+   _braid_GridElt(grid, spill_ref)       = _braid_CTAlloc(char, nupoints);
+   _braid_GridElt(grid, spill_hand)      = 0;
+   _braid_GridElt(grid, spill_nresident) = 0;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_SpillDestroy(braid_Core    core,
+                    _braid_Grid  *grid)
+{
+   braid_Int  iu;
+
+   if (_braid_GridElt(grid, spill_state) != NULL)
+   {
+      if (_braid_GridElt(grid, spill_map) != NULL)
+      {
+         munmap(_braid_GridElt(grid, spill_map), (size_t) _braid_GridElt(grid, nupoints) *
+                _braid_GridElt(grid, spill_slotsize));
+         _braid_GridElt(grid, spill_map) = NULL;
+      }
+      if (_braid_GridElt(grid, spill_data) != NULL)
+      {
+         for (iu = 0; iu < _braid_GridElt(grid, nupoints); iu++)
+         {
+            _braid_SpillDiscard(grid, iu);
+         }
+         _braid_TFree(_braid_GridElt(grid, spill_data));
+         _braid_TFree(_braid_GridElt(grid, spill_sizes));
+         _braid_TFree(_braid_GridElt(grid, spill_buffer));
+      }
+      _braid_TFree(_braid_GridElt(grid, spill_state));
+      _braid_TFree(_braid_GridElt(grid, spill_ref));
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_SpillFetch(braid_Core  core,
+                  braid_Int   level,
+                  braid_Int   iu)
+{
+   _braid_Grid  *grid = _braid_CoreElt(core, grids)[level];
+   char         *spill_state;
+
+   if ((_braid_GridElt(grid, spill_state) == NULL) || (iu < 0))
+   {
+      return _braid_error_flag;
+   }
+
+   spill_state = _braid_GridElt(grid, spill_state);
+   if (spill_state[iu] == _braid_SpillSpilled)
+   {
+      _braid_SpillRead(core, grid, iu);
+      spill_state[iu] = _braid_SpillUntracked;
+   }
+   _braid_SpillTouch(core, grid, iu);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_SpillUpdate(braid_Core  core,
+                   braid_Int   level,
+                   braid_Int   iu)
+{
+   _braid_Grid  *grid = _braid_CoreElt(core, grids)[level];
+   char         *spill_state;
+
+   if ((_braid_GridElt(grid, spill_state) == NULL) || (iu < 0))
+   {
+      return _braid_error_flag;
+   }
+
+   /* A new vector was stored, so the spilled copy (if any) is stale */
+   spill_state = _braid_GridElt(grid, spill_state);
+   if (spill_state[iu] == _braid_SpillSpilled)
+   {
+      _braid_SpillDiscard(grid, iu);
+      spill_state[iu] = _braid_SpillUntracked;
+   }
+   _braid_SpillTouch(core, grid, iu);
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_SpillReduceStats(braid_Core  core)
+{
+   MPI_Comm      comm_world   = _braid_CoreElt(core, comm_world);
+   braid_Real   *spill_stats  = _braid_CoreElt(core, spill_stats);
+   braid_Real   *spill_gstats = _braid_CoreElt(core, spill_gstats);
+   _braid_Grid  *grid         = _braid_CoreElt(core, grids)[0];
+
+   /* Stored u-vectors and the bytes they occupy in memory, counting resident
+    * vectors at their packed size */
+   spill_stats[2] = (braid_Real) _braid_GridElt(grid, nupoints);
+   spill_stats[3] = 0.0;
+   if (_braid_GridElt(grid, spill_state) != NULL)
+   {
+      spill_stats[3] = (braid_Real) _braid_GridElt(grid, spill_nresident) *
+                       (braid_Real) _braid_GridElt(grid, spill_bufsize);
+      if (_braid_GridElt(grid, spill_data) != NULL)
+      {
+         spill_stats[3] += _braid_GridElt(grid, spill_bytes);
+      }
+   }
+
+   MPI_Allreduce(spill_stats, spill_gstats, 4, braid_MPI_REAL, MPI_SUM, comm_world);
+
+   return _braid_error_flag;
+}
+
@@ -43,8 +43,12 @@ _braid_Step(braid_Core         core,
    braid_Int          ilower   = _braid_GridElt(grids[level], ilower);
    braid_Real        *ta       = _braid_GridElt(grids[level], ta);
    braid_BaseVector  *fa       = _braid_GridElt(grids[level], fa);
+   braid_Real        *step_stats = _braid_CoreElt(core, step_stats);
+   braid_Int          tune_max = _braid_CoreElt(core, tune_max);
 
-   braid_Int        ii;
+   braid_BaseVector upred = NULL;
+   braid_Int        ii, solver_iters;
+   braid_Real       stime = 0.0, ttime = 0.0;
 
    ii = index-ilower;
    _braid_StepStatusInit(ta[ii-1], ta[ii], index-1, tol, iter, level, nrefine, gupper, status);
@@ -53,7 +57,18 @@ _braid_Step(braid_Core         core,
    if (ustop == NULL)
    {
       _braid_GetUInit(core, level, index, u, &ustop);
+      _braid_GetUPredict(core, level, index, u, ustop, &upred);
+      if (upred != NULL)
+      {
+         ustop = upred;
+      }
+   }
+
+   if (tune_max)
+   {
+      stime = MPI_Wtime();
    }
+   _braid_TraceBegin(core, &ttime);
 
    if (level == 0)
    {
@@ -75,6 +90,26 @@ _braid_Step(braid_Core         core,
       }
    }
 
+   _braid_TraceEnd(core, _braid_TRACE_STEP, level, index, ttime);
+   if (tune_max)
+   {
+      _braid_CoreElt(core, tune_stats)[3*level] += MPI_Wtime() - stime;
+   }
+
+   if (upred != NULL)
+   {
+      _braid_BaseFree(core, app, upred);
+   }
+
+   /* Count the step, and the solver iterations if reported by the user */
+   step_stats[3*level+2] += 1.0;
+   solver_iters = _braid_StatusElt(status, solver_iters);
+   if (solver_iters > -1)
+   {
+      step_stats[3*level]   += solver_iters;
+      step_stats[3*level+1] += 1.0;
+   }
+
    return _braid_error_flag;
 }
 
@@ -133,3 +168,178 @@ _braid_GetUInit(braid_Core         core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ * Predict a better initial guess for ustop (implicit schemes).  The history is
+ * only used if it comes from the preceding time points, so it never needs to
+ * be invalidated explicitly.
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_GetUPredict(braid_Core         core,
+                   braid_Int          level,
+                   braid_Int          index,
+                   braid_BaseVector   u,
+                   braid_BaseVector   ustop,
+                   braid_BaseVector  *upred_ptr)
+{
+   braid_App          app        = _braid_CoreElt(core, app);
+   braid_Int         *pred_types = _braid_CoreElt(core, pred_types);
+   _braid_Grid      **grids      = _braid_CoreElt(core, grids);
+   _braid_Grid       *grid       = grids[level];
+   braid_Int          ilower     = _braid_GridElt(grid, ilower);
+   braid_Real        *ta         = _braid_GridElt(grid, ta);
+   braid_BaseVector  *pred_u     = _braid_GridElt(grid, pred_u);
+   braid_Real        *pred_t     = _braid_GridElt(grid, pred_t);
+   braid_Int         *pred_index = _braid_GridElt(grid, pred_index);
+
+   braid_BaseVector   upred = NULL, tmp;
+   braid_Real         t[3], w[3];
+   braid_Int          ptype, ii, np, j, k;
+
+   *upred_ptr = NULL;
+
+   ptype = pred_types[level];
+   if (ptype < 0)
+   {
+      ptype = _braid_CoreElt(core, pred_default);
+   }
+   if ( (ptype == braid_PRED_NONE) || _braid_CoreElt(core, adjoint) ||
+        _braid_CoreElt(core, useshell) )
+   {
+      return _braid_error_flag;
+   }
+
+   ii = index-ilower;
+
+   if (ptype == braid_PRED_CORRECTION)
+   {
+      /* Without a stored guess at tstop, there is nothing to correct */
+      if (ustop == u)
+      {
+         pred_index[0] = -1;
+         return _braid_error_flag;
+      }
+
+      /* upred = ustop + (u - guess at tstart) */
+      if ( (pred_u[0] != NULL) && (pred_index[0] == index-1) )
+      {
+         _braid_BaseClone(core, app, ustop, &upred);
+         _braid_BaseSum(core, app, 1.0, u, 1.0, upred);
+         _braid_BaseSum(core, app, -1.0, pred_u[0], 1.0, upred);
+      }
+
+      /* Remember the guess at tstop, it is overwritten after this step */
+      if (pred_u[0] == NULL)
+      {
+         _braid_BaseClone(core, app, ustop, &pred_u[0]);
+      }
+      else
+      {
+         _braid_BaseSum(core, app, 1.0, ustop, 0.0, pred_u[0]);
+      }
+      pred_index[0] = index;
+   }
+   else
+   {
+      /* Extrapolate from u and the inputs of the preceding steps */
+      np = 0;
+      while ( (np < ptype) && (pred_u[np] != NULL) && (pred_index[np] == index-2-np) )
+      {
+         np++;
+      }
+      if (np > 0)
+      {
+         /* Lagrange weights at ta[ii] of the points t[0] = ta[ii-1], t[1], ... */
+         t[0] = ta[ii-1];
+         for (j = 0; j < np; j++)
+         {
+            t[j+1] = pred_t[j];
+         }
+         for (j = 0; j <= np; j++)
+         {
+            w[j] = 1.0;
+            for (k = 0; k <= np; k++)
+            {
+               if (k != j)
+               {
+                  w[j] *= (ta[ii] - t[k]) / (t[j] - t[k]);
+               }
+            }
+         }
+
+         _braid_BaseClone(core, app, u, &upred);
+         _braid_BaseSum(core, app, w[1], pred_u[0], w[0], upred);
+         if (np > 1)
+         {
+            _braid_BaseSum(core, app, w[2], pred_u[1], 1.0, upred);
+         }
+      }
+
+      /* Shift the history and remember u, reusing the oldest vector */
+      tmp = pred_u[ptype-1];
+      for (j = ptype-1; j > 0; j--)
+      {
+         pred_u[j]     = pred_u[j-1];
+         pred_t[j]     = pred_t[j-1];
+         pred_index[j] = pred_index[j-1];
+      }
+      if (tmp == NULL)
+      {
+         _braid_BaseClone(core, app, u, &tmp);
+      }
+      else
+      {
+         _braid_BaseSum(core, app, 1.0, u, 0.0, tmp);
+      }
+      pred_u[0]     = tmp;
+      pred_t[0]     = ta[ii-1];
+      pred_index[0] = index-1;
+   }
+
+   *upred_ptr = upred;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_PredictClean(braid_Core    core,
+                    _braid_Grid  *grid)
+{
+   braid_App          app        = _braid_CoreElt(core, app);
+   braid_BaseVector  *pred_u     = _braid_GridElt(grid, pred_u);
+   braid_Int         *pred_index = _braid_GridElt(grid, pred_index);
+   braid_Int          j;
+
+   for (j = 0; j < 2; j++)
+   {
+      if (pred_u[j] != NULL)
+      {
+         _braid_BaseFree(core, app, pred_u[j]);
+         pred_u[j] = NULL;
+      }
+      pred_index[j] = -1;
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_StepReduceStats(braid_Core  core)
+{
+   MPI_Comm     comm_world   = _braid_CoreElt(core, comm_world);
+   braid_Int    max_levels   = _braid_CoreElt(core, max_levels);
+   braid_Real  *step_stats   = _braid_CoreElt(core, step_stats);
+   braid_Real  *step_gstats = _braid_CoreElt(core, step_gstats);
+
+   step_gstats = _braid_TReAlloc(step_gstats, braid_Real, 3*max_levels);
+   MPI_Allreduce(step_stats, step_gstats, 3*max_levels, braid_MPI_REAL, MPI_SUM, comm_world);
+   _braid_CoreElt(core, step_gstats) = step_gstats;
+
+   return _braid_error_flag;
+}
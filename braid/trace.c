@@ -0,0 +1,231 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing the event timeline (tracing).
+ *
+ *  Each processor records begin/end pairs of the main phases and callbacks
+ *  (steps, messages, buffer packing, spatial coarsening and refinement, and
+ *  the cycle phases of _braid_Drive) as one complete event in a bounded ring
+ *  buffer, so the newest events are kept when it overflows.  At braid_Destroy()
+ *  the events of all processors are written to one Chrome trace (JSON) file
+ *  that can be opened with chrome://tracing or ui.perfetto.dev.  Each
+ *  processor is one process (pid) in the timeline.  The time origin is the
+ *  exit from a barrier at the start of the first braid_Drive(), which aligns
+ *  the clocks of the processors to within the barrier latency.
+ **/
+
+#include "_braid.h"
+
+static const char *_braid_TraceNames[_braid_TRACE_NTYPES] =
+{
+   "step", "send", "wait", "bufpack", "bufunpack", "coarsen", "refine",
+   "FCRelax", "FRestrict", "FInterp", "cycle top"
+};
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TraceInit(braid_Core  core)
+{
+   _braid_Trace  *trace = _braid_CoreElt(core, trace);
+
+   if ( (trace == NULL) || (trace->events != NULL) )
+   {
+      return _braid_error_flag;
+   }
+
+   trace->events  = _braid_CTAlloc(_braid_TraceEvent, trace->size);
+   trace->nevents = 0;
+
+   MPI_Barrier(_braid_CoreElt(core, comm_world));
+   trace->t0 = MPI_Wtime();
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TraceBegin(braid_Core   core,
+                  braid_Real  *start_ptr)
+{
+   if (_braid_CoreElt(core, trace) != NULL)
+   {
+      *start_ptr = MPI_Wtime();
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TraceEnd(braid_Core  core,
+                braid_Int   type,
+                braid_Int   level,
+                braid_Int   index,
+                braid_Real  start)
+{
+   _braid_Trace       *trace = _braid_CoreElt(core, trace);
+   _braid_TraceEvent  *event;
+
+   if ( (trace == NULL) || (trace->events == NULL) )
+   {
+      return _braid_error_flag;
+   }
+
+   event = &(trace->events[trace->nevents % trace->size]);
+   event->start = start - trace->t0;
+   event->dur   = MPI_Wtime() - start;
+   event->type  = type;
+   event->level = level;
+   event->index = index;
+   event->iter  = _braid_CoreElt(core, niter);
+   trace->nevents++;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Append *line* to the text in *text_ptr*, growing it as needed
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_TraceAppend(char       **text_ptr,
+                   braid_Int   *len_ptr,
+                   braid_Int   *alloc_ptr,
+                   const char  *line)
+{
+   char      *text  = *text_ptr;
+   braid_Int  len   = *len_ptr;
+   braid_Int  alloc = *alloc_ptr;
+   braid_Int  n     = strlen(line);
+
+   if (len + n + 1 > alloc)
+   {
+      alloc = 2*(len + n + 1);
+      text  = _braid_TReAlloc(text, char, alloc);
+   }
+   strcpy(&text[len], line);
+
+   *text_ptr  = text;
+   *len_ptr   = len + n;
+   *alloc_ptr = alloc;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TraceDestroy(braid_Core  core)
+{
+   MPI_Comm            comm_world = _braid_CoreElt(core, comm_world);
+   braid_Int           myid       = _braid_CoreElt(core, myid_world);
+   _braid_Trace       *trace      = _braid_CoreElt(core, trace);
+   _braid_TraceEvent  *event;
+   MPI_File            fh;
+   char               *text, line[256];
+   braid_Int           len, alloc, nprocs, first, n, k;
+   braid_Real          size, offset, total;
+
+   if (trace == NULL)
+   {
+      return _braid_error_flag;
+   }
+
+   /* Write the file if anything was traced (collective) */
+   if (trace->events != NULL)
+   {
+      MPI_Comm_size(comm_world, &nprocs);
+
+      len   = 0;
+      alloc = 256;
+      text  = _braid_TAlloc(char, alloc);
+      text[0] = '\0';
+      if (myid == 0)
+      {
+         _braid_TraceAppend(&text, &len, &alloc, "{\"traceEvents\":[\n");
+      }
+      sprintf(line, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}",
+              (myid == 0) ? "" : ",\n", myid, myid);
+      _braid_TraceAppend(&text, &len, &alloc, line);
+      sprintf(line, ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"sort_index\":%d}}",
+              myid, myid);
+      _braid_TraceAppend(&text, &len, &alloc, line);
+      if (trace->nevents > trace->size)
+      {
+         sprintf(line, ",\n{\"name\":\"process_labels\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"labels\":\"%d oldest events dropped\"}}",
+                 myid, trace->nevents - trace->size);
+         _braid_TraceAppend(&text, &len, &alloc, line);
+      }
+
+      /* Events in the order they were recorded, oldest first.  Every event but
+       * the very first one in the file is preceded by a comma. */
+      n     = _braid_min(trace->nevents, trace->size);
+      first = trace->nevents - n;
+      for (k = first; k < trace->nevents; k++)
+      {
+         event = &(trace->events[k % trace->size]);
+         sprintf(line, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,"
+                 "\"args\":{\"level\":%d,\"index\":%d,\"iter\":%d}}",
+                 _braid_TraceNames[event->type], myid, 1.0e6*event->start, 1.0e6*event->dur,
+                 event->level, event->index, event->iter);
+         _braid_TraceAppend(&text, &len, &alloc, line);
+      }
+      if (myid == nprocs-1)
+      {
+         _braid_TraceAppend(&text, &len, &alloc, "\n],\"displayTimeUnit\":\"ms\"}\n");
+      }
+
+      /* File offsets (a real is used since the total may not fit an int) */
+      size = (braid_Real) len;
+      MPI_Scan(&size, &offset, 1, braid_MPI_REAL, MPI_SUM, comm_world);
+      MPI_Allreduce(&size, &total, 1, braid_MPI_REAL, MPI_SUM, comm_world);
+      offset -= size;
+
+      if (MPI_File_open(comm_world, trace->filename, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                        MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      {
+         _braid_Error(braid_ERROR_GENERIC, "Cannot open trace file");
+      }
+      else
+      {
+         MPI_File_set_size(fh, (MPI_Offset) total);
+         MPI_File_write_at(fh, (MPI_Offset) offset, text, len, MPI_CHAR, MPI_STATUS_IGNORE);
+         MPI_File_close(&fh);
+      }
+      _braid_TFree(text);
+      _braid_TFree(trace->events);
+   }
+
+   _braid_TFree(trace->filename);
+   _braid_TFree(trace);
+   _braid_CoreElt(core, trace) = NULL;
+
+   return _braid_error_flag;
+}
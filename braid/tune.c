@@ -0,0 +1,457 @@
+/*BHEADER**********************************************************************
+ * Copyright (c) 2013, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * This file is part of XBraid. For support, post issues to the XBraid Github page.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License (as published by the Free Software
+ * Foundation) version 2.1 dated February 1999.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the IMPLIED WARRANTY OF MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the terms and conditions of the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ ***********************************************************************EHEADER*/
+
+
+/**
+ *  Source file implementing the online auto-tuner.
+ *
+ *  A configuration is a coarsening factor, a number of CF-relaxations (0 is
+ *  F-relaxation) and a number of levels, used on all levels.  Each candidate
+ *  is run for two cycles.  The first one moves the iterate onto the new
+ *  hierarchy.  The second one measures the wall time t of a cycle and the
+ *  convergence factor rho, the ratio of the residual norms.  The first cycle
+ *  of the solve is not measured, since the smooth initial error is usually
+ *  reduced unusually fast.  The score
+ *
+ *     t / -log(rho)
+ *
+ *  is the predicted time per e-fold reduction of the residual, so the lowest
+ *  score has the lowest predicted time to any tolerance.  The tuner starts
+ *  with the user's settings and moves to the best neighbor configuration
+ *  (cfactor doubled or halved, one more or one less relaxation, one level more
+ *  or less) until no neighbor improves or tune_max trials have been done.
+ *  Every trial cycle is a regular MGRIT cycle and counts as an iteration.
+ *
+ *  Between cycles, the hierarchy is rebuilt as after a refinement, but on the
+ *  same fine grid.  The values at the new level-0 C-points are computed first
+ *  with an F-relaxation sweep on the old hierarchy.
+ **/
+
+#include <math.h>
+#include "_braid.h"
+#include "util.h"
+
+/*----------------------------------------------------------------------------
+ * Number of levels that _braid_InitHierarchy() builds with coarsening factor
+ * 'cfactor' and at most 'max_levels' levels
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_TuneNLevels(braid_Core  core,
+                   braid_Int   cfactor,
+                   braid_Int   max_levels)
+{
+   braid_Int  gupper     = _braid_CoreElt(core, gupper);
+   braid_Int  min_coarse = _braid_CoreElt(core, min_coarse);
+   braid_Int  level, gcupper;
+
+   if (gupper <= min_coarse)
+   {
+      return 1;
+   }
+   gcupper = gupper;
+   for (level = 0; level < max_levels-1; level++)
+   {
+      gcupper = gcupper / cfactor;
+      if ( (gcupper < 1) || (gcupper < min_coarse) )
+      {
+         break;
+      }
+   }
+
+   return level+1;
+}
+
+/*----------------------------------------------------------------------------
+ * Scale of the temporal residual norm with coarsening factor 'cfactor', e.g.,
+ * the square root of the number of fine-grid C-points for the 2-norm
+ *----------------------------------------------------------------------------*/
+
+static braid_Real
+_braid_TuneNormScale(braid_Core  core,
+                     braid_Int   cfactor)
+{
+   braid_Int   tnorm = _braid_CoreElt(core, tnorm);
+   braid_Real  nc    = (braid_Real) (_braid_CoreElt(core, gupper) / cfactor + 1);
+
+   if (tnorm == 1)
+   {
+      return nc;
+   }
+   else if (tnorm == 2)
+   {
+      return sqrt(nc);
+   }
+   return 1.0;
+}
+
+/*----------------------------------------------------------------------------
+ * Rebuild the hierarchy with configuration 'c' of the tuner
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_TuneRebuild(braid_Core  core,
+                   braid_Int   c)
+{
+   braid_App          app      = _braid_CoreElt(core, app);
+   _braid_Tune       *tune     = _braid_CoreElt(core, tune);
+   _braid_Grid      **grids    = _braid_CoreElt(core, grids);
+   braid_Int          nlevels  = _braid_CoreElt(core, nlevels);
+   braid_Int          ilower   = _braid_GridElt(grids[0], ilower);
+   braid_Int          iupper   = _braid_GridElt(grids[0], iupper);
+   braid_Int          ncpoints = _braid_GridElt(grids[0], ncpoints);
+   braid_Int          nupoints = _braid_GridElt(grids[0], nupoints);
+   braid_Int          old_cf   = _braid_GridElt(grids[0], cfactor);
+   braid_Real        *ta       = _braid_GridElt(grids[0], ta);
+   braid_Int          cfactor  = tune->configs[3*c];
+   braid_Int          nrelax   = tune->configs[3*c+1];
+   braid_Int          ml       = tune->configs[3*c+2];
+
+   braid_BaseVector  *save, u;
+   braid_Real        *f_ta, scale;
+   _braid_Grid       *f_grid;
+   braid_Int          level, interval, flo, fhi, fi, ci, i, iu, sflag;
+
+   /* Copy the values at the new level-0 C-points (or all stored points) */
+   save = _braid_CTAlloc(braid_BaseVector, iupper-ilower+1);
+   if (nupoints == iupper-ilower+1)
+   {
+      for (i = ilower; i <= iupper; i++)
+      {
+         _braid_UGetVectorRef(core, 0, i, &u);
+         _braid_BaseClone(core, app, u, &save[i-ilower]);
+      }
+   }
+   else
+   {
+      /* Generate the F-point values with an F-relaxation sweep, as in FAccess */
+      _braid_UCommInitF(core, 0);
+      for (interval = ncpoints; interval > -1; interval--)
+      {
+         _braid_GetInterval(core, 0, interval, &flo, &fhi, &ci);
+         if (flo <= fhi)
+         {
+            _braid_UGetVector(core, 0, flo-1, &u);
+         }
+         for (fi = flo; fi <= fhi; fi++)
+         {
+            _braid_Step(core, 0, fi, NULL, u);
+            _braid_USetVector(core, 0, fi, u, 0);
+            if ( _braid_IsCPoint(fi, cfactor) )
+            {
+               _braid_BaseClone(core, app, u, &save[fi-ilower]);
+            }
+         }
+         if (flo <= fhi)
+         {
+            _braid_BaseFree(core, app, u);
+         }
+         if ( (ci > -1) && _braid_IsCPoint(ci, cfactor) )
+         {
+            _braid_UGetVectorRef(core, 0, ci, &u);
+            _braid_BaseClone(core, app, u, &save[ci-ilower]);
+         }
+      }
+      _braid_UCommWait(core, 0);
+   }
+   f_ta = _braid_CTAlloc(braid_Real, iupper-ilower+1);
+   for (i = ilower; i <= iupper; i++)
+   {
+      f_ta[i-ilower] = ta[i-ilower];
+   }
+
+   /* Destroy the old hierarchy (see FRefine) */
+   _braid_TFree(_braid_CoreElt(core, rfactors));
+   _braid_TFree(_braid_CoreElt(core, rdtvalues));
+   _braid_TFree(_braid_CoreElt(core, tnorm_a));
+   for (level = 0; level < nlevels; level++)
+   {
+      _braid_GridDestroy(core, grids[level]);
+      grids[level] = NULL;
+   }
+
+   /* Apply the configuration on all levels */
+   braid_SetMaxLevels(core, ml);
+   for (level = 0; level < ml; level++)
+   {
+      _braid_CoreElt(core, cfactors)[level] = cfactor;
+      _braid_CoreElt(core, nrels)[level]    = nrelax;
+   }
+
+   /* Build the new hierarchy on the same fine grid */
+   _braid_GridInit(core, 0, ilower, iupper, &f_grid);
+   ta = _braid_GridElt(f_grid, ta);
+   for (i = ilower; i <= iupper; i++)
+   {
+      ta[i-ilower] = f_ta[i-ilower];
+   }
+   _braid_TFree(f_ta);
+   _braid_InitHierarchy(core, f_grid, 0);
+
+   /* Set the stored values */
+   for (i = ilower; i <= iupper; i++)
+   {
+      if (save[i-ilower] != NULL)
+      {
+         _braid_UGetIndex(core, 0, i, &iu, &sflag);
+         if (sflag == 0)
+         {
+            _braid_USetVectorRef(core, 0, i, save[i-ilower]);
+         }
+         else
+         {
+            _braid_BaseFree(core, app, save[i-ilower]);
+         }
+      }
+   }
+   _braid_TFree(save);
+
+   /* The residual norm is now taken over different C-points, so rescale the
+    * initial norm for relative tolerances */
+   scale = _braid_TuneNormScale(core, cfactor) / _braid_TuneNormScale(core, old_cf);
+   if (_braid_CoreElt(core, rnorm0) != braid_INVALID_RNORM)
+   {
+      _braid_CoreElt(core, rnorm0) *= scale;
+   }
+   for (i = 0; i < _braid_CoreElt(core, nmembers); i++)
+   {
+      if (_braid_CoreElt(core, ens_rnorm0)[i] != braid_INVALID_RNORM)
+      {
+         _braid_CoreElt(core, ens_rnorm0)[i] *= scale;
+      }
+   }
+
+   tune->current = c;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the first neighbor of the best configuration that has not been
+ * tried yet and adds it to the list of tried configurations (-1 if none)
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_TuneNextConfig(braid_Core  core)
+{
+   _braid_Tune  *tune    = _braid_CoreElt(core, tune);
+   braid_Int     gupper  = _braid_CoreElt(core, gupper);
+   braid_Int    *configs = tune->configs;
+   braid_Int     cf      = configs[3*tune->best];
+   braid_Int     nu      = configs[3*tune->best+1];
+   braid_Int     nl      = configs[3*tune->best+2];
+   braid_Int     cand[6][3] = { {2*cf, nu, nl}, {cf/2, nu, nl}, {cf, nu+1, nl},
+                                {cf, nu-1, nl}, {cf, nu, nl+1}, {cf, nu, nl-1} };
+   braid_Int     j, k, n;
+
+   for (j = 0; j < 6; j++)
+   {
+      if ( (cand[j][0] < 2) || (cand[j][0] > gupper) ||
+           (cand[j][1] < 0) || (cand[j][1] > 2) ||
+           (cand[j][2] > tune->max_levels) )
+      {
+         continue;
+      }
+      cand[j][2] = _braid_TuneNLevels(core, cand[j][0], cand[j][2]);
+      if (cand[j][2] < 2)
+      {
+         continue;
+      }
+      for (k = 0; k < tune->ntried; k++)
+      {
+         if ( (configs[3*k]   == cand[j][0]) &&
+              (configs[3*k+1] == cand[j][1]) &&
+              (configs[3*k+2] == cand[j][2]) )
+         {
+            break;
+         }
+      }
+      if (k == tune->ntried)
+      {
+         n = tune->ntried++;
+         configs[3*n]   = cand[j][0];
+         configs[3*n+1] = cand[j][1];
+         configs[3*n+2] = cand[j][2];
+         return n;
+      }
+   }
+
+   return -1;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_AutoTune(braid_Core   core,
+                braid_Int   *retuned_ptr)
+{
+   MPI_Comm      comm        = _braid_CoreElt(core, comm);
+   braid_Int     myid        = _braid_CoreElt(core, myid);
+   braid_Int     tune_max    = _braid_CoreElt(core, tune_max);
+   braid_Int     print_level = _braid_CoreElt(core, print_level);
+   _braid_Tune  *tune        = _braid_CoreElt(core, tune);
+   _braid_Grid **grids       = _braid_CoreElt(core, grids);
+
+   braid_Real    rnorm, rho, tcycle, ltime;
+   braid_Int     c, next;
+
+   *retuned_ptr = 0;
+
+   if (tune == NULL)
+   {
+      tune = _braid_CTAlloc(_braid_Tune, 1);
+      tune->configs = _braid_CTAlloc(braid_Int, 3*(tune_max+1));
+      tune->scores  = _braid_CTAlloc(braid_Real, tune_max+1);
+      tune->max_levels = _braid_CoreElt(core, max_levels);
+      _braid_CoreElt(core, tune) = tune;
+
+      /* The tuner changes the hierarchy, which these features rely on */
+      if ( _braid_CoreElt(core, refine) || _braid_CoreElt(core, adjoint) ||
+           _braid_CoreElt(core, richardson) || _braid_CoreElt(core, est_error) ||
+           _braid_CoreElt(core, periodic) || _braid_CoreElt(core, useshell) ||
+           (_braid_CoreElt(core, nlevels) < 2) )
+      {
+         tune->phase = 2;
+         return _braid_error_flag;
+      }
+
+      /* The user's settings are the first configuration */
+      tune->configs[0] = _braid_GridElt(grids[0], cfactor);
+      tune->configs[1] = _braid_CoreElt(core, nrels)[0];
+      tune->configs[2] = _braid_CoreElt(core, nlevels);
+      tune->ntried  = 1;
+      tune->current = 0;
+      tune->best    = 0;
+      tune->phase   = -1;
+   }
+
+   if (tune->phase == 2)
+   {
+      return _braid_error_flag;
+   }
+   else if (tune->phase == -1)
+   {
+      tune->phase = 0;
+      return _braid_error_flag;
+   }
+
+   _braid_GetRNorm(core, -1, &rnorm);
+   ltime = MPI_Wtime();
+
+   if (tune->phase == 0)
+   {
+      /* Start the measured cycle */
+      tune->rprev = rnorm;
+      tune->tprev = ltime;
+      tune->phase = 1;
+      return _braid_error_flag;
+   }
+
+   /* Score the configuration of the last cycle (same decision everywhere) */
+   ltime -= tune->tprev;
+   MPI_Allreduce(&ltime, &tcycle, 1, braid_MPI_REAL, MPI_MAX, comm);
+   c   = tune->current;
+   rho = (tune->rprev > 0.0) ? rnorm / tune->rprev : 1.0;
+   if ( (rho > 0.0) && (rho < 1.0) )
+   {
+      tune->scores[c] = tcycle / -log(rho);
+   }
+   else
+   {
+      tune->scores[c] = HUGE_VAL;               /* no convergence */
+   }
+   if (tune->scores[c] < tune->scores[tune->best])
+   {
+      tune->best = c;
+   }
+
+   if ( (myid == 0) && (print_level > 1) )
+   {
+      _braid_printf("  Braid: tune cfactor %d, nrelax %d, levels %d: rho %1.2e, cycle %1.2e s\n",
+                    tune->configs[3*c], tune->configs[3*c+1], tune->configs[3*c+2], rho, tcycle);
+   }
+
+   /* Move on to the next trial, or settle on the best configuration */
+   next = -1;
+   if (tune->ntried <= tune_max)
+   {
+      next = _braid_TuneNextConfig(core);
+   }
+   if (next < 0)
+   {
+      next = tune->best;
+      tune->phase = 2;
+      if ( (myid == 0) && (print_level > 0) )
+      {
+         _braid_printf("  Braid: auto-tune chose cfactor %d, nrelax %d, max_levels %d\n",
+                       tune->configs[3*next], tune->configs[3*next+1], tune->configs[3*next+2]);
+      }
+   }
+   else
+   {
+      tune->phase = 0;
+   }
+   if (next != tune->current)
+   {
+      _braid_TuneRebuild(core, next);
+      *retuned_ptr = 1;
+   }
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TuneReduceStats(braid_Core  core)
+{
+   MPI_Comm     comm_world  = _braid_CoreElt(core, comm_world);
+   braid_Int    max_levels  = _braid_CoreElt(core, max_levels);
+   braid_Real  *tune_stats  = _braid_CoreElt(core, tune_stats);
+   braid_Real  *tune_gstats = _braid_CoreElt(core, tune_gstats);
+
+   tune_gstats = _braid_TReAlloc(tune_gstats, braid_Real, 3*max_levels);
+   MPI_Allreduce(tune_stats, tune_gstats, 3*max_levels, braid_MPI_REAL, MPI_SUM, comm_world);
+   _braid_CoreElt(core, tune_gstats) = tune_gstats;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_TuneDestroy(braid_Core  core)
+{
+   _braid_Tune  *tune = _braid_CoreElt(core, tune);
+
+   if (tune != NULL)
+   {
+      _braid_TFree(tune->configs);
+      _braid_TFree(tune->scores);
+      _braid_TFree(tune);
+      _braid_CoreElt(core, tune) = NULL;
+   }
+
+   return _braid_error_flag;
+}
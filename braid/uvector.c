@@ -107,6 +107,10 @@ _braid_UGetVectorRef(braid_Core         core,
    braid_Int            iu, sflag;
 
    _braid_UGetIndex(core, level, index, &iu, &sflag);
+   if (sflag == 0)
+   {
+      _braid_SpillFetch(core, level, iu);
+   }
    if (sflag>-2) // We have a full point or a shell (iu>=0)
    {
       u = ua[iu];
@@ -139,12 +143,15 @@ _braid_USetVectorRef(braid_Core        core,
    if (sflag == 0)
    {
       ua[iu] = u;
+      _braid_MemMove(core, &ua[iu]);
+      _braid_SpillUpdate(core, level, iu);
    }
    else if (sflag == -1)
    {
       braid_App    app = _braid_CoreElt(core, app);
       _braid_BaseSFree(core,  app, u);
       ua[iu] = u;
+      _braid_MemMove(core, &ua[iu]);
    }
 
    return _braid_error_flag;
@@ -176,7 +183,18 @@ _braid_UGetVector(braid_Core         core,
       /* If a recv was initiated, receive u value from neighbor processor */
       if (recv_index > _braid_RecvIndexNull)
       {
-         _braid_CommWait(core, &recv_handle);
+         if ( _braid_CoreElt(core, tune_max) )
+         {
+            /* Time the wait for the auto-tuner statistics */
+            braid_Real  wtime = MPI_Wtime();
+            _braid_CommWait(core, &recv_handle);
+            _braid_CoreElt(core, tune_stats)[3*level+1] += MPI_Wtime() - wtime;
+            _braid_CoreElt(core, tune_stats)[3*level+2] += 1.0;
+         }
+         else
+         {
+            _braid_CommWait(core, &recv_handle);
+         }
          _braid_GridElt(grids[level], recv_index)  = _braid_RecvIndexNull;
          _braid_GridElt(grids[level], recv_handle) = recv_handle;
          u = ua[-1];
@@ -187,6 +205,7 @@ _braid_UGetVector(braid_Core         core,
       _braid_UGetIndex(core, level, index, &iu, &sflag);
       if (sflag == 0)
       {
+         _braid_SpillFetch(core, level, iu);
          _braid_BaseClone(core, app,  ua[iu], &u);
       }
       else if (sflag == -1)
@@ -201,6 +220,116 @@ _braid_UGetVector(braid_Core         core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ * Complete the pending receives of asynchronous relaxation on 'level', oldest
+ * first.  If 'block' is false, stop at the first one that has not arrived.
+ * The newest arrived value replaces the stale value.
+ *----------------------------------------------------------------------------*/
+
+static braid_Int
+_braid_UCommAsyncLand(braid_Core  core,
+                      _braid_Grid *grid,
+                      braid_Int   block)
+{
+   braid_App            app         = _braid_CoreElt(core, app);
+   _braid_CommHandle  **async_recv  = _braid_GridElt(grid, async_recv);
+   braid_Int            async_nrecv = _braid_GridElt(grid, async_nrecv);
+   braid_Int            i, n, flag;
+
+   for (n = 0; n < async_nrecv; n++)
+   {
+      if (!block)
+      {
+         _braid_CommTest(core, async_recv[n], &flag);
+         if (!flag)
+         {
+            break;
+         }
+      }
+      _braid_CommWait(core, &async_recv[n]);
+      if (_braid_GridElt(grid, async_ghost) != NULL)
+      {
+         _braid_BaseFree(core, app, _braid_GridElt(grid, async_ghost));
+      }
+      _braid_GridElt(grid, async_ghost) = _braid_GridElt(grid, async_land);
+      _braid_GridElt(grid, async_land)  = NULL;
+   }
+
+   /* Shift the receives still pending to the front */
+   for (i = n; i < async_nrecv; i++)
+   {
+      async_recv[i-n] = async_recv[i];
+   }
+   _braid_GridElt(grid, async_nrecv) = async_nrecv - n;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ * Like UGetVector(), but if 'index' is my "receive index" and the message has
+ * not arrived yet, return a copy of the newest value received earlier (at most
+ * async_stale times in a row) and leave the receive pending.  Pending receives
+ * are matched in order by later messages from the same neighbor, so they can
+ * simply be completed by later calls.
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_UGetVectorAsync(braid_Core         core,
+                       braid_Int          level,
+                       braid_Int          index,
+                       braid_BaseVector  *u_ptr)
+{
+   braid_App            app         = _braid_CoreElt(core, app);
+   braid_Int            async_stale = _braid_CoreElt(core, async_stale);
+   braid_Real          *async_stats = _braid_CoreElt(core, async_stats);
+   _braid_Grid         *grid        = _braid_CoreElt(core, grids)[level];
+   braid_BaseVector    *ua          = _braid_GridElt(grid, ua);
+   braid_Int            recv_index  = _braid_GridElt(grid, recv_index);
+   _braid_CommHandle   *recv_handle = _braid_GridElt(grid, recv_handle);
+   braid_Int            nstale      = _braid_GridElt(grid, async_nstale);
+   braid_Int            flag;
+
+   if ( (index != recv_index) || (recv_index == _braid_RecvIndexNull) || (recv_handle == NULL) )
+   {
+      _braid_UGetVector(core, level, index, u_ptr);
+      return _braid_error_flag;
+   }
+   async_stats[0] += 1.0;
+
+   /* Consume what has landed so far */
+   _braid_UCommAsyncLand(core, grid, 0);
+   _braid_CommTest(core, recv_handle, &flag);
+
+   if ( !flag && (_braid_GridElt(grid, async_ghost) != NULL) && (nstale < async_stale) )
+   {
+      /* Continue from the stale value, and leave the receive pending */
+      _braid_CommHandleElt(recv_handle, vector_ptr) = &_braid_GridElt(grid, async_land);
+      _braid_GridElt(grid, async_recv) =
+         _braid_TReAlloc(_braid_GridElt(grid, async_recv), _braid_CommHandle *,
+                         _braid_GridElt(grid, async_nrecv)+1);
+      _braid_GridElt(grid, async_recv)[_braid_GridElt(grid, async_nrecv)++] = recv_handle;
+      _braid_GridElt(grid, recv_index)   = _braid_RecvIndexNull;
+      _braid_GridElt(grid, recv_handle)  = NULL;
+      _braid_GridElt(grid, async_nstale) = nstale+1;
+      _braid_BaseClone(core, app, _braid_GridElt(grid, async_ghost), u_ptr);
+      async_stats[1] += 1.0;
+   }
+   else
+   {
+      /* Wait for the newest value (earlier messages arrive first) */
+      _braid_UCommAsyncLand(core, grid, 1);
+      _braid_UGetVector(core, level, index, u_ptr);
+      if (_braid_GridElt(grid, async_ghost) != NULL)
+      {
+         _braid_BaseFree(core, app, _braid_GridElt(grid, async_ghost));
+      }
+      _braid_BaseClone(core, app, ua[-1], &_braid_GridElt(grid, async_ghost));
+      _braid_GridElt(grid, async_nstale) = 0;
+   }
+
+   return _braid_error_flag;
+}
+
 /* Retrieve the last time-step vector.  Note that the
  * last time-step is only available after Braid is 
  * finished cycling and done is True.  This routine should
@@ -284,11 +413,13 @@ _braid_USetVector(braid_Core        core,
       if (move)
       {
          ua[iu] = u;                                   /* move the vector */
+         _braid_MemMove(core, &ua[iu]);
       }
       else
       {
          _braid_BaseClone(core, app,  u, &ua[iu]); /* copy the vector */
       }
+      _braid_SpillUpdate(core, level, iu);
    }
    else if (sflag == -1) // We have a shell
    {
@@ -301,6 +432,7 @@ _braid_USetVector(braid_Core        core,
          // We are on an F-point, with shellvector option. We only keep the shell.
          _braid_BaseSFree(core,  app, u);
          ua[iu] = u;                                   /* move the vector */
+         _braid_MemMove(core, &ua[iu]);
       }
       else
       {
@@ -370,6 +502,7 @@ _braid_UCommInitBasic(braid_Core  core,
             // We should never get here : we do not communicate shells...
             abort();
          }
+         _braid_SpillFetch(core, level, iu);
          _braid_CommSendInit(core, level, send_index, ua[iu], &send_handle);
          send_index = _braid_SendIndexNull;
       }
@@ -415,6 +548,7 @@ _braid_UCommInit(braid_Core  core,
       if ( _braid_IsCPoint(iupper, cfactor) )
       {
          _braid_UGetIndex(core, level, iupper, &iu, &sflag);
+         _braid_SpillFetch(core, level, iu);
          _braid_CommSendInit(core, level, iupper, ua[iu], &send_handle);
          send_index = _braid_SendIndexNull;
       }
@@ -467,6 +601,7 @@ _braid_UCommInitF(braid_Core  core,
       if ( _braid_IsCPoint(iupper, cfactor) && _braid_IsFPoint(iupper+1, cfactor))
       {
          _braid_UGetIndex(core, level, iupper, &iu, &sflag);
+         _braid_SpillFetch(core, level, iu);
          _braid_CommSendInit(core, level, iupper, ua[iu], &send_handle);
          send_index = _braid_SendIndexNull;
       }
@@ -506,3 +641,38 @@ _braid_UCommWait(braid_Core  core,
    return _braid_error_flag;
 }
 
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_UCommAsyncDestroy(braid_Core    core,
+                         _braid_Grid  *grid)
+{
+   braid_App  app = _braid_CoreElt(core, app);
+
+   _braid_UCommAsyncLand(core, grid, 1);
+   _braid_TFree(_braid_GridElt(grid, async_recv));
+   if (_braid_GridElt(grid, async_ghost) != NULL)
+   {
+      _braid_BaseFree(core, app, _braid_GridElt(grid, async_ghost));
+      _braid_GridElt(grid, async_ghost) = NULL;
+   }
+   _braid_GridElt(grid, async_nstale) = 0;
+
+   return _braid_error_flag;
+}
+
+/*----------------------------------------------------------------------------
+ *----------------------------------------------------------------------------*/
+
+braid_Int
+_braid_UCommAsyncReduceStats(braid_Core  core)
+{
+   MPI_Comm    comm_world   = _braid_CoreElt(core, comm_world);
+   braid_Real *async_stats  = _braid_CoreElt(core, async_stats);
+   braid_Real *async_gstats = _braid_CoreElt(core, async_gstats);
+
+   MPI_Allreduce(async_stats, async_gstats, 2, braid_MPI_REAL, MPI_SUM, comm_world);
+
+   return _braid_error_flag;
+}